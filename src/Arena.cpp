@@ -0,0 +1,70 @@
+#include "Arena.h"
+#include <algorithm>
+#include <new>
+
+using namespace std;
+
+// fold in counters of later rounds
+void ArenaStats::add(const ArenaStats& other) {
+    rounds += other.rounds; // rounds
+    allocations += other.allocations; // arena allocations
+    bytes += other.bytes; // arena bytes
+    systemAllocations += other.systemAllocations; // system blocks
+    systemBytes += other.systemBytes; // system bytes
+    peakBytes = max(peakBytes, other.peakBytes); // largest round
+}
+
+// print the counters
+void ArenaStats::print(ostream& out) const {
+    out << "Rounds: " << rounds << "\n"; // root moves
+    out << "Arena allocations: " << allocations << " (" << bytes << " bytes)\n"; // served by the arena
+    out << "System allocations: " << systemAllocations << " (" << systemBytes << " bytes)\n"; // blocks from the heap
+    out << "Peak per round: " << peakBytes << " bytes\n"; // largest round
+}
+
+// constructor
+Arena::Arena() : current(0), offset(0), usedBefore(0) {
+    round.rounds = 1; // the first round starts now
+}
+
+// destructor, returns every block
+Arena::~Arena() {
+    for (const Block& block : blocks) {
+        ::operator delete(block.data); // free block
+    }
+}
+
+// bump allocate
+void* Arena::do_allocate(size_t bytes, size_t alignment) {
+    while (current < blocks.size()) {
+        Block& block = blocks[current]; // block being filled
+        uintptr_t base = reinterpret_cast<uintptr_t>(block.data); // block address
+        size_t start = ((base + offset + alignment - 1) & ~(alignment - 1)) - base; // aligned offset
+        if (start + bytes <= block.size) {
+            offset = start + bytes; // claim
+            round.allocations++;
+            round.bytes += bytes;
+            round.peakBytes = max(round.peakBytes, usedBefore + offset); // bytes in use
+            return block.data + start;
+        }
+        usedBefore += offset; // move on to the next kept block
+        offset = 0;
+        current++;
+    }
+
+    size_t size = max(BLOCK_SIZE, bytes + alignment); // room for the request even when misaligned
+    Block block{static_cast<byte*>(::operator new(size)), size}; // new block
+    blocks.push_back(block);
+    round.systemAllocations++;
+    round.systemBytes += size;
+    return do_allocate(bytes, alignment); // serve from the new block
+}
+
+// start a new round, everything allocated before is dead
+void Arena::reset() {
+    current = 0; // rewind to the first block
+    offset = 0;
+    usedBefore = 0;
+    round = ArenaStats(); // new counters
+    round.rounds = 1;
+}
@@ -0,0 +1,57 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <ostream>
+#include <vector>
+
+using namespace std;
+
+struct ArenaStats { // allocation counters of one or more arena rounds
+    uint64_t rounds = 0; // resets covered
+    uint64_t allocations = 0; // requests served from the arena
+    uint64_t bytes = 0; // bytes requested
+    uint64_t systemAllocations = 0; // blocks taken from the system heap
+    uint64_t systemBytes = 0; // bytes of those blocks
+    size_t peakBytes = 0; // most bytes in use during one round
+
+    void add(const ArenaStats& other); // fold in counters of later rounds
+    void print(ostream& out) const; // print the counters
+};
+
+// bump allocator for memory that lives exactly one round, such as the search
+// objects of one root move. deallocation is a no-op and reset rewinds every
+// block at once, keeping the blocks, so once the first round has sized them
+// later rounds never touch the system heap. not thread safe: one owner
+// allocates between resets
+class Arena : public pmr::memory_resource {
+    struct Block { // memory taken from the system heap
+        byte* data; // start
+        size_t size; // capacity in bytes
+    };
+
+    vector<Block> blocks; // every block, reused in order
+    size_t current; // block being filled
+    size_t offset; // bytes used in the current block
+    size_t usedBefore; // bytes used in blocks before the current one
+    ArenaStats round; // counters since the last reset
+
+    void* do_allocate(size_t bytes, size_t alignment) override; // bump allocate
+    void do_deallocate(void*, size_t, size_t) override {} // freed all at once by reset
+    bool do_is_equal(const pmr::memory_resource& other) const noexcept override { return this == &other; } // only this arena frees its memory
+
+public:
+    static constexpr size_t BLOCK_SIZE = 256 * 1024; // smallest block taken from the system
+
+    Arena(); // constructor
+    ~Arena() override; // destructor, returns every block
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    void reset(); // start a new round, everything allocated before is dead
+    const ArenaStats& getRoundStats() const { return round; } // counters since the last reset
+};
+
+#endif
@@ -0,0 +1,70 @@
+#include "AsyncSearch.h"
+#include "Trace.h"
+
+using namespace std;
+
+// constructor
+AsyncSearch::AsyncSearch() : search(nullptr), finished(false) {
+}
+
+// destructor, stops and joins any running search
+AsyncSearch::~AsyncSearch() {
+    stop(); // finish early
+    if (worker.joinable()) worker.join(); // wait for the thread
+    releaseSearch(); // destroy search
+}
+
+// destroy the joined search before its arena is reset
+void AsyncSearch::releaseSearch() {
+    if (!search) return;
+    pmr::polymorphic_allocator<>(&arena).delete_object(search); // destroy search
+    search = nullptr;
+}
+
+// begin searching, after joining any earlier search
+void AsyncSearch::start(const Board& board, TranspositionTable& tt, PawnTables& pawnTables, MoveHistory& heuristics, const SearchLimits& limits,
+                        SearchProgress progress, SearchDone done) {
+    if (worker.joinable()) worker.join(); // one search at a time
+    releaseSearch(); // previous root move
+    arena.reset(); // its memory is free again
+    position = board; // private copy
+    finished = false; // no result yet
+    result = SearchResult(); // clear result
+    search = pmr::polymorphic_allocator<>(&arena).new_object<Search>(position, tt, pawnTables, heuristics, &arena); // new search
+    if (progress) search->setProgressCallback(move(progress)); // iteration reports
+    
+    worker = thread([this, limits, done] {
+        Trace::setThreadName("search"); // track of the main search thread
+        TRACE_SCOPE("think");
+        SearchResult searchResult = search->think(limits); // think until done or stopped
+        if (done) done(searchResult); // report before waking waiters
+        {
+            lock_guard<mutex> lock(doneMutex);
+            result = searchResult; // publish result
+            finished = true;
+        }
+        doneSignal.notify_all(); // wake waitFor
+    });
+}
+
+// ask the search to finish with its best move so far
+void AsyncSearch::stop() {
+    if (search && worker.joinable()) search->stop();
+}
+
+// the pondered move was played, switch to the time control
+void AsyncSearch::ponderHit() {
+    if (search && worker.joinable()) search->ponderHit();
+}
+
+// block until finished or the timeout passes, true when finished
+bool AsyncSearch::waitFor(int timeoutMs) {
+    unique_lock<mutex> lock(doneMutex);
+    return doneSignal.wait_for(lock, chrono::milliseconds(timeoutMs), [this] { return finished || !worker.joinable(); });
+}
+
+// join the search and return its result
+const SearchResult& AsyncSearch::wait() {
+    if (worker.joinable()) worker.join(); // wait for the thread
+    return result;
+}
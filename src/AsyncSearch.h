@@ -0,0 +1,54 @@
+#ifndef ASYNCSEARCH_H
+#define ASYNCSEARCH_H
+
+#include "Arena.h"
+#include "Board.h"
+#include "Search.h"
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+using namespace std;
+
+using SearchDone = function<void(const SearchResult&)>; // called on the search thread with the final result
+
+// handle to a search running on a background thread. the search works on a
+// private copy of the position, so the caller's board may change while it
+// thinks. stop keeps the best move found so far. the search and its workers
+// are allocated in an arena that start resets, so each root move reuses the
+// memory of the one before
+class AsyncSearch {
+    Board position; // copy being searched
+    Arena arena; // memory of the current search
+    Search* search; // running search, allocated in the arena
+    thread worker; // thread running it
+    
+    void releaseSearch(); // destroy the joined search before its arena is reset
+    SearchResult result; // final result
+    mutex doneMutex; // guards finished
+    condition_variable doneSignal; // wakes waitFor
+    bool finished; // result is ready
+    
+public:
+    AsyncSearch(); // constructor
+    ~AsyncSearch(); // destructor, stops and joins any running search
+    AsyncSearch(const AsyncSearch&) = delete;
+    AsyncSearch& operator=(const AsyncSearch&) = delete;
+    
+    void start(const Board& board, TranspositionTable& tt, PawnTables& pawnTables, MoveHistory& heuristics, const SearchLimits& limits,
+               SearchProgress progress = nullptr, SearchDone done = nullptr); // begin searching, after joining any earlier search
+    void stop(); // ask the search to finish with its best move so far
+    void ponderHit(); // the pondered move was played, switch to the time control
+    bool waitFor(int timeoutMs); // block until finished or the timeout passes, true when finished
+    const SearchResult& wait(); // join the search and return its result
+    
+    bool isActive() const { return worker.joinable(); } // started and not yet joined
+    const Board& getPosition() const { return position; } // position being searched
+    const OrderingStats* getOrderingStats() const { return search ? &search->getOrderingStats() : nullptr; } // counters, valid once joined
+    const ArenaStats& getArenaStats() const { return arena.getRoundStats(); } // allocations of the current search
+};
+
+#endif
@@ -0,0 +1,188 @@
+#include "Attacks.h"
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+static array<Magic, 64> rookMagics; // rook lookup parameters
+static array<Magic, 64> bishopMagics; // bishop lookup parameters
+static Bitboard rookTable[0x19000]; // rook attacks for every square and blocker subset
+static Bitboard bishopTable[0x1480]; // bishop attacks for every square and blocker subset
+static array<array<Bitboard, 64>, 64> betweenTable; // squares strictly between two aligned squares
+static array<array<Bitboard, 64>, 64> lineTable; // whole line through two aligned squares
+static bool pextEnabled = false; // index with pext instead of magic multiplication
+static bool initialized = false; // tables built
+
+static const int ROOK_DIRECTIONS[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}}; // rook rays
+static const int BISHOP_DIRECTIONS[4][2] = {{1, 1}, {1, -1}, {-1, 1}, {-1, -1}}; // bishop rays
+
+#if defined(__x86_64__) || defined(__i386__)
+__attribute__((target("bmi2"))) static uint64_t pext(uint64_t value, uint64_t mask) { // parallel bit extract
+    return _pext_u64(value, mask);
+}
+
+static bool cpuHasBmi2() { // runtime cpu detection
+    return __builtin_cpu_supports("bmi2");
+}
+#else
+static uint64_t pext(uint64_t, uint64_t) { // never called without bmi2
+    return 0;
+}
+
+static bool cpuHasBmi2() { // runtime cpu detection
+    return false;
+}
+#endif
+
+// build tables before main runs, so every lookup sees them
+[[maybe_unused]] static const bool attacksReady = (Attacks::init(), true);
+
+// walk rays from sq until the first blocker, used only while building tables
+static Bitboard slidingAttacks(int sq, Bitboard occupied, const int directions[4][2]) {
+    Bitboard attacks = 0; // attacks
+    for (int dir = 0; dir < 4; ++dir) {
+        int r = sq / 8 + directions[dir][0]; // row
+        int c = sq % 8 + directions[dir][1]; // column
+        while (r >= 0 && r < 8 && c >= 0 && c < 8) {
+            Bitboard bit = squareBit(squareIndex(r, c)); // square bit
+            attacks |= bit; // attacked
+            if (occupied & bit) break; // blocked
+            r += directions[dir][0];
+            c += directions[dir][1];
+        }
+    }
+    return attacks; // return attacks
+}
+
+// squares whose occupancy matters for a slider on sq
+static Bitboard relevantMask(int sq, const int directions[4][2]) {
+    Bitboard edges = ((RANK_1_BB | RANK_8_BB) & ~(RANK_1_BB << (8 * (sq / 8)))) |
+                     ((FILE_A_BB | FILE_H_BB) & ~(FILE_A_BB << (sq % 8))); // edges not on the slider's own rank or file
+    return slidingAttacks(sq, 0, directions) & ~edges; // rays without their last square
+}
+
+// xorshift generator seeded per rank, so the magic search is quick and repeatable
+static uint64_t sparseRandom(uint64_t& state) {
+    uint64_t value = ~0ULL; // and of three draws leaves few bits set
+    for (int i = 0; i < 3; ++i) {
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        value &= state * 2685821657736338717ULL;
+    }
+    return value;
+}
+
+// table index for blockers
+Bitboard Attacks::slidingIndex(const Magic& entry, Bitboard occupied) {
+    if (pextEnabled) {
+        return pext(occupied, entry.mask); // pext index
+    }
+    return ((occupied & entry.mask) * entry.magic) >> entry.shift; // magic index
+}
+
+// fill one slider's tables
+void Attacks::initSlider(Magic* magics, Bitboard* table, const int directions[4][2]) {
+    const uint64_t seeds[8] = {728, 10316, 55013, 32803, 12281, 15100, 16645, 255}; // per rank seeds
+    Bitboard occupancies[4096]; // every blocker subset of one mask
+    Bitboard references[4096]; // attacks for each subset
+    int epoch[4096] = {}; // attempt that last wrote each slot
+    int attempt = 0; // magic candidates tried
+    Bitboard* next = table; // first free slot of the shared table
+    
+    for (int sq = 0; sq < 64; ++sq) {
+        Magic& entry = magics[sq]; // parameters for sq
+        entry.mask = relevantMask(sq, directions); // relevant blockers
+        entry.shift = 64 - bitCount(entry.mask); // index width
+        entry.attacks = next; // slice of the table
+        
+        // enumerate every subset of the mask with the carry-rippler trick
+        int size = 0; // number of subsets
+        Bitboard subset = 0;
+        do {
+            occupancies[size] = subset;
+            references[size] = slidingAttacks(sq, subset, directions);
+            size++;
+            subset = (subset - entry.mask) & entry.mask;
+        } while (subset);
+        next += size; // reserve the slice
+        
+        if (pextEnabled) { // pext indexes are collision free
+            for (int i = 0; i < size; ++i) {
+                entry.attacks[pext(occupancies[i], entry.mask)] = references[i];
+            }
+            continue;
+        }
+        
+        uint64_t state = seeds[sq / 8]; // generator state
+        for (int i = 0; i < size;) { // try candidates until one maps every subset without a destructive collision
+            do {
+                entry.magic = sparseRandom(state); // candidate
+            } while (bitCount((entry.magic * entry.mask) >> 56) < 6); // skip candidates that mix too few bits
+            
+            ++attempt; // new attempt
+            for (i = 0; i < size; ++i) {
+                unsigned index = static_cast<unsigned>(slidingIndex(entry, occupancies[i])); // slot
+                if (epoch[index] < attempt) {
+                    epoch[index] = attempt; // claim slot
+                    entry.attacks[index] = references[i]; // store attacks
+                } else if (entry.attacks[index] != references[i]) {
+                    break; // destructive collision, try another magic
+                }
+            }
+        }
+    }
+}
+
+// build slider and between tables, safe to call more than once
+void Attacks::init() {
+    if (initialized) return; // already built
+    pextEnabled = cpuHasBmi2(); // pick indexing scheme
+    initSlider(rookMagics.data(), rookTable, ROOK_DIRECTIONS); // rook tables
+    initSlider(bishopMagics.data(), bishopTable, BISHOP_DIRECTIONS); // bishop tables
+    
+    for (int from = 0; from < 64; ++from) {
+        for (int to = 0; to < 64; ++to) {
+            Bitboard toBit = squareBit(to); // to square
+            Bitboard ends = squareBit(from) | toBit; // both squares
+            betweenTable[from][to] = 0; // not aligned
+            lineTable[from][to] = 0; // not aligned
+            if (rook(from, 0) & toBit) {
+                betweenTable[from][to] = rook(from, toBit) & rook(to, squareBit(from)); // shared rank or file
+                lineTable[from][to] = (rook(from, 0) & rook(to, 0)) | ends; // shared rank or file
+            } else if (bishop(from, 0) & toBit) {
+                betweenTable[from][to] = bishop(from, toBit) & bishop(to, squareBit(from)); // shared diagonal
+                lineTable[from][to] = (bishop(from, 0) & bishop(to, 0)) | ends; // shared diagonal
+            }
+        }
+    }
+    initialized = true; // built
+}
+
+// slider lookups use the bmi2 pext instruction
+bool Attacks::usesPext() {
+    return pextEnabled;
+}
+
+// squares a rook on sq attacks through occupied
+Bitboard Attacks::rook(int sq, Bitboard occupied) {
+    const Magic& entry = rookMagics[sq]; // parameters
+    return entry.attacks[slidingIndex(entry, occupied)]; // lookup
+}
+
+// squares a bishop on sq attacks through occupied
+Bitboard Attacks::bishop(int sq, Bitboard occupied) {
+    const Magic& entry = bishopMagics[sq]; // parameters
+    return entry.attacks[slidingIndex(entry, occupied)]; // lookup
+}
+
+// squares strictly between two aligned squares, else empty
+Bitboard Attacks::between(int from, int to) {
+    return betweenTable[from][to]; // lookup
+}
+
+// whole rank, file or diagonal through two aligned squares, else empty
+Bitboard Attacks::line(int a, int b) {
+    return lineTable[a][b]; // lookup
+}
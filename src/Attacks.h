@@ -0,0 +1,97 @@
+#ifndef ATTACKS_H
+#define ATTACKS_H
+
+#include "Bitboard.h"
+#include <array>
+
+using namespace std;
+
+using AttackTable = array<Bitboard, 64>; // one attack mask per square
+
+constexpr Bitboard leaperAttacks(int sq, const int offsets[][2], int count) { // squares a leaper on sq reaches
+    Bitboard attacks = 0;
+    int row = sq / 8; // row
+    int col = sq % 8; // column
+    for (int i = 0; i < count; ++i) {
+        int r = row + offsets[i][0]; // target row
+        int c = col + offsets[i][1]; // target column
+        if (r >= 0 && r < 8 && c >= 0 && c < 8) {
+            attacks |= Bitboard(1) << (r * 8 + c);
+        }
+    }
+    return attacks;
+}
+
+constexpr AttackTable generateKnightAttacks() { // knight attacks for every square
+    const int offsets[8][2] = {{2, 1}, {2, -1}, {-2, 1}, {-2, -1}, {1, 2}, {1, -2}, {-1, 2}, {-1, -2}};
+    AttackTable table{};
+    for (int sq = 0; sq < 64; ++sq) {
+        table[sq] = leaperAttacks(sq, offsets, 8);
+    }
+    return table;
+}
+
+constexpr AttackTable generateKingAttacks() { // king attacks for every square
+    const int offsets[8][2] = {{1, 1}, {1, 0}, {1, -1}, {0, 1}, {0, -1}, {-1, 1}, {-1, 0}, {-1, -1}};
+    AttackTable table{};
+    for (int sq = 0; sq < 64; ++sq) {
+        table[sq] = leaperAttacks(sq, offsets, 8);
+    }
+    return table;
+}
+
+constexpr array<AttackTable, 2> generatePawnAttacks() { // pawn captures for every square, white then black
+    const int whiteOffsets[2][2] = {{1, -1}, {1, 1}};
+    const int blackOffsets[2][2] = {{-1, -1}, {-1, 1}};
+    array<AttackTable, 2> tables{};
+    for (int sq = 0; sq < 64; ++sq) {
+        tables[0][sq] = leaperAttacks(sq, whiteOffsets, 2);
+        tables[1][sq] = leaperAttacks(sq, blackOffsets, 2);
+    }
+    return tables;
+}
+
+inline constexpr AttackTable KNIGHT_ATTACKS = generateKnightAttacks(); // built at compile time
+inline constexpr AttackTable KING_ATTACKS = generateKingAttacks(); // built at compile time
+inline constexpr array<AttackTable, 2> PAWN_ATTACKS = generatePawnAttacks(); // built at compile time
+
+static_assert(KNIGHT_ATTACKS[0] == 0x20400ULL, "knight on a1 reaches b3 and c2");
+static_assert(KING_ATTACKS[0] == 0x302ULL, "king on a1 reaches a2, b1 and b2");
+
+struct Magic { // per-square slider lookup parameters
+    Bitboard mask; // relevant blocker squares, board edges excluded
+    Bitboard magic; // multiplier hashing blockers to a table index
+    Bitboard* attacks; // this square's slice of the attack table
+    unsigned shift; // 64 minus the number of relevant bits
+};
+
+// leapers come from the constexpr tables above; sliders come from magic or,
+// where the cpu supports bmi2, pext-indexed tables built once at startup
+class Attacks { // attack mask lookups
+    static Bitboard slidingIndex(const Magic& entry, Bitboard occupied); // table index for blockers
+    static void initSlider(Magic* magics, Bitboard* table, const int directions[4][2]); // fill one slider's tables
+    
+public:
+    static void init(); // build slider and between tables, safe to call more than once
+    static bool usesPext(); // slider lookups use the bmi2 pext instruction
+    
+    static Bitboard rook(int sq, Bitboard occupied); // squares a rook on sq attacks through occupied
+    static Bitboard bishop(int sq, Bitboard occupied); // squares a bishop on sq attacks through occupied
+    static Bitboard queen(int sq, Bitboard occupied) { // squares a queen on sq attacks through occupied
+        return rook(sq, occupied) | bishop(sq, occupied);
+    }
+    static Bitboard between(int from, int to); // squares strictly between two aligned squares, else empty
+    static Bitboard line(int a, int b); // whole rank, file or diagonal through two aligned squares, else empty
+
+    static Bitboard knight(int sq) { // squares a knight on sq attacks
+        return KNIGHT_ATTACKS[sq];
+    }
+    static Bitboard king(int sq) { // squares a king on sq attacks
+        return KING_ATTACKS[sq];
+    }
+    static Bitboard pawn(Color color, int sq) { // squares a pawn of color on sq attacks
+        return PAWN_ATTACKS[colorIndex(color)][sq];
+    }
+};
+
+#endif
@@ -0,0 +1,55 @@
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include "types.h"
+#include <bit>
+#include <cstdint>
+
+using namespace std;
+
+using Bitboard = uint64_t; // one bit per square, a1 is bit 0 and h8 is bit 63
+
+const Bitboard FILE_A_BB = 0x0101010101010101ULL; // file a
+const Bitboard FILE_H_BB = FILE_A_BB << 7; // file h
+const Bitboard RANK_1_BB = 0xFFULL; // rank 1
+const Bitboard RANK_8_BB = RANK_1_BB << 56; // rank 8
+
+inline int squareIndex(int row, int col) { // square index from row and column
+    return row * 8 + col;
+}
+
+inline int squareIndex(const Position& pos) { // square index from position
+    return squareIndex(pos.r, pos.c);
+}
+
+inline Position squareToPosition(int sq) { // position from square index
+    return Position(sq / 8, sq % 8);
+}
+
+inline Bitboard squareBit(int sq) { // single bit mask for square
+    return Bitboard(1) << sq;
+}
+
+inline int lsb(Bitboard bb) { // index of lowest set bit
+    return countr_zero(bb);
+}
+
+inline int popLsb(Bitboard& bb) { // pop lowest set bit and return its index
+    int sq = countr_zero(bb);
+    bb &= bb - 1;
+    return sq;
+}
+
+inline int bitCount(Bitboard bb) { // number of set bits
+    return popcount(bb);
+}
+
+inline int colorIndex(Color c) { // array index for color
+    return c == Color::WHITE ? 0 : 1;
+}
+
+inline int pieceIndex(PieceType t) { // array index for piece type
+    return static_cast<int>(t);
+}
+
+#endif
@@ -1,5 +1,9 @@
 #include "Board.h"
 #include "PieceFactory.h"
+#include "Attacks.h"
+#include "Evaluation.h"
+#include "Stats.h"
+#include "Trace.h"
 #include <algorithm>
 #include <sstream>
 #include <iomanip>
@@ -11,6 +15,7 @@ using namespace std;
 Board::Board() : currentPlayer(Color::WHITE), 
                  gameState(GameState::PLAYING),
                  enPassantTarget(-1, -1),
+                 castlingRights(CASTLE_ALL),
                  halfmoveClock(0),
                  fullmoveNumber(1) { // constructor with default values
     for (int rowNum = 0; rowNum < 8; ++rowNum) { // initialize squares
@@ -18,26 +23,29 @@ Board::Board() : currentPlayer(Color::WHITE),
             squares[rowNum][colNum] = nullptr; // initialize squares
         }
     }
+    clearMasks(); // initialize masks
+    zobristKey = computeZobristKey(); // initialize Zobrist key
 }
 
 // copy constructor
 Board::Board(const Board& other) // copy constructor with default values
-    : currentPlayer(other.currentPlayer), // copy current player
+    : pieceBB(other.pieceBB), // copy piece masks
+      colorBB(other.colorBB), // copy color masks
+      occupiedBB(other.occupiedBB), // copy occupancy
+      zobristKey(other.zobristKey), // copy Zobrist key
+      pawnKey(other.pawnKey), // copy pawn key
+      midgameScore(other.midgameScore), // copy middlegame sum
+      endgameScore(other.endgameScore), // copy endgame sum
+      gamePhase(other.gamePhase), // copy phase
+      currentPlayer(other.currentPlayer), // copy current player
       gameState(other.gameState), // copy game state
       enPassantTarget(other.enPassantTarget), // copy en passant target
+      castlingRights(other.castlingRights), // copy castling rights
       halfmoveClock(other.halfmoveClock), // copy halfmove clock
       fullmoveNumber(other.fullmoveNumber), // copy fullmove number
-      moveHistory(other.moveHistory) { // copy move history
-
-    for (int rowNum = 0; rowNum < 8; ++rowNum) { // initialize squares
-        for (int colNum = 0; colNum < 8; ++colNum) {
-            if (other.squares[rowNum][colNum]) { // if square is not empty
-                squares[rowNum][colNum] = other.squares[rowNum][colNum]->clone(); // copy square
-            } else {
-                squares[rowNum][colNum] = nullptr; // initialize square
-            }
-        }
-    }
+      moveHistory(other.moveHistory), // copy move history
+      keyHistory(other.keyHistory) { // copy key history
+    squares = other.squares; // pieces are shared, so copying the pointers copies the placement
 }
 
 // assignment operator
@@ -46,19 +54,21 @@ Board& Board::operator=(const Board& other) {
         currentPlayer = other.currentPlayer; // copy current player
         gameState = other.gameState; // copy game state
         enPassantTarget = other.enPassantTarget; // copy en passant target
+        castlingRights = other.castlingRights; // copy castling rights
         halfmoveClock = other.halfmoveClock; // copy halfmove clock
         fullmoveNumber = other.fullmoveNumber;
         moveHistory = other.moveHistory;
-
-        for (int rowNum = 0; rowNum < 8; ++rowNum) { // initialize squares
-            for (int colNum = 0; colNum < 8; ++colNum) {
-                if (other.squares[rowNum][colNum]) { // if square is not empty
-                    squares[rowNum][colNum] = other.squares[rowNum][colNum]->clone(); // copy square
-                } else {
-                    squares[rowNum][colNum] = nullptr; // initialize square
-                }
-            }
-        }
+        keyHistory = other.keyHistory; // copy key history
+        pieceBB = other.pieceBB; // copy piece masks
+        colorBB = other.colorBB; // copy color masks
+        occupiedBB = other.occupiedBB; // copy occupancy
+        zobristKey = other.zobristKey; // copy Zobrist key
+        pawnKey = other.pawnKey; // copy pawn key
+        midgameScore = other.midgameScore; // copy middlegame sum
+        endgameScore = other.endgameScore; // copy endgame sum
+        gamePhase = other.gamePhase; // copy phase
+        positionCache.valid = false; // regenerate for the new position
+        squares = other.squares; // pieces are shared, so copying the pointers copies the placement
 
         observers.clear(); // clear observers
     }
@@ -67,6 +77,7 @@ Board& Board::operator=(const Board& other) {
 
 // create copy
 unique_ptr<Board> Board::createCopy() const {
+    STATS_SCOPE(StatId::BOARD_COPY);
     return make_unique<Board>(*this); // create copy
 }
 
@@ -88,7 +99,7 @@ void Board::detach(const Observer* observer) {
 // get piece
 const Piece* Board::getPiece(const Position& pos) const {
     if (!pos.isValid()) return nullptr;
-    return squares[pos.r][pos.c].get(); // get piece
+    return squares[pos.r][pos.c]; // get piece
 }
 
 // get piece
@@ -97,15 +108,101 @@ const Piece* Board::getPiece(int row, int col) const {
 }
 
 // set piece
-void Board::setPiece(const Position& pos, unique_ptr<Piece> piece) {
+void Board::setPiece(const Position& pos, const Piece* piece) {
     if (!pos.isValid()) return;
-    squares[pos.r][pos.c] = std::move(piece); // set piece
+    int sq = squareIndex(pos); // square index
+    liftPiece(sq); // drop whatever was there
+    placePiece(sq, piece); // set piece
 }
 
 // remove piece
 void Board::removePiece(const Position& pos) {
     if (!pos.isValid()) return;
-    squares[pos.r][pos.c] = nullptr; // remove piece
+    liftPiece(squareIndex(pos)); // remove piece
+}
+
+// place piece
+void Board::placePiece(int sq, const Piece* piece) {
+    if (!piece) return;
+    Bitboard bit = squareBit(sq); // square bit
+    pieceBB[colorIndex(piece->getColor())][pieceIndex(piece->getType())] |= bit; // add to piece mask
+    colorBB[colorIndex(piece->getColor())] |= bit; // add to color mask
+    occupiedBB |= bit; // add to occupancy
+    zobristKey ^= Zobrist::piece(piece->getColor(), piece->getType(), sq); // hash piece in
+    if (piece->getType() == PieceType::PAWN) pawnKey ^= Zobrist::piece(piece->getColor(), PieceType::PAWN, sq); // hash pawn in
+    midgameScore += Evaluation::midgame(piece->getColor(), piece->getType(), sq); // add piece score
+    endgameScore += Evaluation::endgame(piece->getColor(), piece->getType(), sq);
+    gamePhase += Evaluation::phase(piece->getType()); // add phase
+    squares[sq / 8][sq % 8] = piece; // set piece
+    positionCache.valid = false; // placement changed
+}
+
+// lift piece
+const Piece* Board::liftPiece(int sq) {
+    const Piece* piece = squares[sq / 8][sq % 8]; // take piece
+    if (piece) {
+        squares[sq / 8][sq % 8] = nullptr; // empty square
+        Bitboard bit = squareBit(sq); // square bit
+        pieceBB[colorIndex(piece->getColor())][pieceIndex(piece->getType())] &= ~bit; // remove from piece mask
+        colorBB[colorIndex(piece->getColor())] &= ~bit; // remove from color mask
+        occupiedBB &= ~bit; // remove from occupancy
+        zobristKey ^= Zobrist::piece(piece->getColor(), piece->getType(), sq); // hash piece out
+        if (piece->getType() == PieceType::PAWN) pawnKey ^= Zobrist::piece(piece->getColor(), PieceType::PAWN, sq); // hash pawn out
+        midgameScore -= Evaluation::midgame(piece->getColor(), piece->getType(), sq); // remove piece score
+        endgameScore -= Evaluation::endgame(piece->getColor(), piece->getType(), sq);
+        gamePhase -= Evaluation::phase(piece->getType()); // remove phase
+        positionCache.valid = false; // placement changed
+    }
+    return piece; // return piece
+}
+
+// clear masks
+void Board::clearMasks() {
+    for (auto& masks : pieceBB) {
+        masks.fill(0); // clear piece masks
+    }
+    colorBB.fill(0); // clear color masks
+    occupiedBB = 0; // clear occupancy
+    pawnKey = 0; // no pawns
+    midgameScore = 0; // no pieces, no score
+    endgameScore = 0;
+    gamePhase = 0;
+}
+
+// en passant key
+uint64_t Board::enPassantKey() const {
+    if (!enPassantTarget.isValid()) return 0; // no en passant target
+    
+    // only hash the file when the side to move has a pawn that can take there
+    int pawnRank = enPassantTarget.r + ((currentPlayer == Color::WHITE) ? -1 : 1); // capturing pawn rank
+    Bitboard pawns = getPieces(currentPlayer, PieceType::PAWN); // capturing pawns
+    for (int cO = -1; cO <= 1; cO += 2) {
+        Position pawnPos(pawnRank, enPassantTarget.c + cO); // capturing pawn position
+        if (pawnPos.isValid() && (pawns & squareBit(squareIndex(pawnPos)))) {
+            return Zobrist::enPassant(enPassantTarget.c); // return file key
+        }
+    }
+    return 0;
+}
+
+// compute Zobrist key
+uint64_t Board::computeZobristKey() const {
+    uint64_t key = 0; // key
+    for (Color color : {Color::WHITE, Color::BLACK}) {
+        for (int typeNum = 0; typeNum < 6; ++typeNum) {
+            PieceType type = static_cast<PieceType>(typeNum); // piece type
+            Bitboard pieces = getPieces(color, type); // piece mask
+            while (pieces) {
+                key ^= Zobrist::piece(color, type, popLsb(pieces)); // hash piece
+            }
+        }
+    }
+    if (currentPlayer == Color::BLACK) {
+        key ^= Zobrist::side(); // hash side to move
+    }
+    key ^= Zobrist::castling(castlingRights); // hash castling rights
+    key ^= enPassantKey(); // hash en passant file
+    return key; // return key
 }
 
 // move
@@ -128,6 +225,7 @@ bool Board::move(const string& from, const string& to, PieceType promotion) {
 
 // move
 bool Board::move(const Move& move) {
+    TRACE_SCOPE("Board::move");
     if (!isValidMove(move)) {
         notifyNoMove(move, "Invalid move"); // notify no move
         return false; // invalid move
@@ -135,10 +233,8 @@ bool Board::move(const Move& move) {
     
     if (executeMove(move)) {
         moveHistory.push_back(move); // add move to move history
+        STATS_COUNT_MOVE();
         
-        updateEnPassantTarget(move); // update en passant target
-        
-        switchPlayer(); // switch player
         notifyObservers(); // notify observers
         
         notifyMove(move); // notify move
@@ -156,15 +252,14 @@ bool Board::isValidMove(const Position& from, const Position& to) const {
     if (!piece) return false; // invalid move
     if (piece->getColor() != currentPlayer) return false; // invalid move
     
-    if (!piece->isLegal(from, to, *this)) return false; // invalid move
-    
-    Move move = createMove(from, to); // create move
-    
-    if (!move.init.isValid()) return false;
-    
-    if (wouldBeInCheckAfterMove(move)) return false;
-    
-    return true;
+    int fromSq = squareIndex(from); // from square
+    int toSq = squareIndex(to); // to square
+    for (PackedMove move : getLegalMoveList(currentPlayer)) { // legal moves of this position
+        if (move.from() == fromSq && move.to() == toSq) {
+            return true; // valid move
+        }
+    }
+    return false; // invalid move
 }
 
 // is valid move
@@ -174,6 +269,8 @@ bool Board::isValidMove(const Move& move) const {
 
 // is in check
 bool Board::isInCheck(Color player) const {
+    if (isCached(player)) return positionCache.inCheck; // already known
+    
     Position kingPos = findKing(player); // find king
     if (!kingPos.isValid()) return false; // invalid move
     
@@ -182,18 +279,13 @@ bool Board::isInCheck(Color player) const {
 
 // is checkmate
 bool Board::isCheckmate(Color player) const {
-    if (!isInCheck(player)) return false; // is not in check
-    
-    std::vector<Move> legalMoves = getAllLegalMoves(player);
-    return legalMoves.empty();
+    GameState state = getTerminalState(player); // cached state
+    return state == GameState::CHECKMATE_WHITE_WINS || state == GameState::CHECKMATE_BLACK_WINS;
 }
 
 // is stalemate
 bool Board::isStalemate(Color player) const {
-    if (isInCheck(player)) return false;   // is not in check
-    
-    std::vector<Move> legalMoves = getAllLegalMoves(player);
-    return legalMoves.empty();
+    return getTerminalState(player) == GameState::DRAW_STALEMATE; // cached state
 }
 
 // is draw
@@ -211,9 +303,12 @@ void Board::setup() {
     currentPlayer = Color::WHITE; // set current player
     gameState = GameState::PLAYING; // set game state
     enPassantTarget = Position(-1, -1); // set en passant target
+    castlingRights = CASTLE_ALL; // set castling rights
     halfmoveClock = 0; // set halfmove clock
     fullmoveNumber = 1; // set fullmove number
     moveHistory.clear(); // clear move history
+    keyHistory.clear(); // clear key history
+    zobristKey = computeZobristKey(); // recompute Zobrist key
     
     notifyObservers(); // notify observers
 }
@@ -225,68 +320,310 @@ void Board::clear() {
             squares[rowNum][colNum] = nullptr; // initialize square
         }
     }
+    clearMasks(); // clear masks
+    castlingRights = CASTLE_ALL; // pieces placed on their home squares may castle
+    keyHistory.clear(); // clear key history
+    zobristKey = computeZobristKey(); // recompute Zobrist key
 }
 
 // is valid setup
 bool Board::isValidSetup() const {
-    int whiteKingNum = 0, blackKingNum = 0; // initialize white kings and black kings
-    bool pawnsOnBackRanks = false; // initialize pawns on back ranks
-    
-    for (int rowNum = 0; rowNum < 8; ++rowNum) {
-        for (int colNum = 0; colNum < 8; ++colNum) {
-            const Piece* piece = getPiece(rowNum, colNum);
-            if (!piece) continue;
-            
-            if (piece->getType() == PieceType::KING) {
-                if (piece->getColor() == Color::WHITE) whiteKingNum++; // increment white kings
-                else blackKingNum++; // increment black kings
-            }
-            
-            if (piece->getType() == PieceType::PAWN && (rowNum == 0 || rowNum == 7)) {
-                pawnsOnBackRanks = true; // set pawns on back ranks
-            }
-        }
-    }
+    int whiteKingNum = bitCount(getPieces(Color::WHITE, PieceType::KING)); // count white kings
+    int blackKingNum = bitCount(getPieces(Color::BLACK, PieceType::KING)); // count black kings
+    Bitboard pawns = getPieces(Color::WHITE, PieceType::PAWN) | getPieces(Color::BLACK, PieceType::PAWN); // all pawns
+    bool pawnsOnBackRanks = (pawns & (RANK_1_BB | RANK_8_BB)) != 0; // pawns on back ranks
     
-    if (whiteKingNum != 1 || blackKingNum != 1 || pawnsOnBackRanks) {
+    if (whiteKingNum != 1 || blackKingNum != 1 || pawnsOnBackRanks || !hasPossibleMaterial()) {
         return false; // invalid setup
     }
     
     return !isInCheck(Color::WHITE) && !isInCheck(Color::BLACK); // is valid setup
 }
 
+// piece counts could arise in a real game: at most 16 pieces and 8 pawns a
+// side, and every piece beyond the starting set paid for by a missing pawn.
+// positions like that have at most 218 legal moves, which MoveList relies on
+bool Board::hasPossibleMaterial() const {
+    for (Color color : {Color::WHITE, Color::BLACK}) {
+        int pawns = bitCount(getPieces(color, PieceType::PAWN)); // pawns
+        int promoted = max(0, bitCount(getPieces(color, PieceType::QUEEN)) - 1) // pieces that must have been promoted
+                     + max(0, bitCount(getPieces(color, PieceType::ROOK)) - 2)
+                     + max(0, bitCount(getPieces(color, PieceType::BISHOP)) - 2)
+                     + max(0, bitCount(getPieces(color, PieceType::KNIGHT)) - 2);
+        if (bitCount(getOccupancy(color)) > 16 || pawns > 8 || promoted > 8 - pawns) {
+            return false; // too much material
+        }
+    }
+    return true; // possible
+}
+
 // get all legal moves
 vector<Move> Board::getAllLegalMoves(Color player) const {
-    vector<Move> legalMoves; // initialize legal moves
+    STATS_SCOPE(StatId::LEGAL_MOVES);
+    return toMoves(getLegalMoveList(player)); // unpack cached moves
+}
+
+// get legal moves
+vector<Move> Board::getLegalMoves(const Position& pos) const {
+    const Piece* piece = getPiece(pos); // get piece
+    if (!piece) return {}; // invalid move
     
-    for (int rowNum = 0; rowNum < 8; ++rowNum) { // initialize squares
-        for (int colNum = 0; colNum < 8; ++colNum) { // initialize squares
-            const Piece* piece = getPiece(Position(rowNum, colNum)); // get piece
-            if (piece && piece->getColor() == player) { // if piece is not empty and color is player
-                vector<Move> pieceMoves = getLegalMoves(Position(rowNum, colNum)); // get legal moves
-                legalMoves.insert(legalMoves.end(), pieceMoves.begin(), pieceMoves.end()); // insert legal moves
+    vector<Move> legalMoves; // legal moves
+    int sq = squareIndex(pos); // piece square
+    for (PackedMove move : getLegalMoveList(piece->getColor())) {
+        if (move.from() == sq) {
+            legalMoves.push_back(toMove(move)); // move of this piece
+        }
+    }
+    return legalMoves; // get legal moves
+}
+
+// legal moves, generated once per position
+const MoveList& Board::getLegalMoveList(Color player) const {
+    if (!isCached(player)) {
+        positionCache.moves.clear(); // drop stale moves
+        generateLegalMoves(player, positionCache.moves); // generate moves
+        
+        Bitboard king = getPieces(player, PieceType::KING); // king
+        positionCache.inCheck = king && (attackersTo(lsb(king), occupiedBB) & getOccupancy(oppositeColor(player))); // in check
+        
+        if (positionCache.moves.empty()) { // no legal moves
+            if (positionCache.inCheck) {
+                positionCache.state = (player == Color::WHITE) ? GameState::CHECKMATE_BLACK_WINS : GameState::CHECKMATE_WHITE_WINS;
+            } else {
+                positionCache.state = GameState::DRAW_STALEMATE;
             }
+        } else {
+            positionCache.state = positionCache.inCheck ? GameState::CHECK : GameState::PLAYING;
         }
+        
+        positionCache.key = zobristKey; // position
+        positionCache.player = player; // side
+        positionCache.valid = true; // filled
     }
+    return positionCache.moves; // return moves
+}
+
+// checkmate, stalemate, check or playing, from the cache
+GameState Board::getTerminalState(Color player) const {
+    getLegalMoveList(player); // fill cache
+    return positionCache.state; // return state
+}
+
+// append legal moves of every piece of player
+void Board::generateLegalMoves(Color player, MoveList& moves) const {
+    LegalityMasks masks = computeLegalityMasks(player); // checkers and pins
+    if (masks.kingSq < 0) return; // a side without a king has no legal moves
     
-    return legalMoves; // get all legal moves
+    Bitboard from = getOccupancy(player); // only visit squares holding the player's pieces
+    if (bitCount(masks.checkers) > 1) {
+        from = squareBit(masks.kingSq); // double check, only the king may move
+    }
+    if (player == Color::WHITE) {
+        generateAll<Color::WHITE>(masks, from, moves); // white generators
+    } else {
+        generateAll<Color::BLACK>(masks, from, moves); // black generators
+    }
 }
 
-// get legal moves
-vector<Move> Board::getLegalMoves(const Position& pos) const {
+// append legal moves of the piece on pos
+void Board::generateLegalMoves(const Position& pos, MoveList& moves) const {
     const Piece* piece = getPiece(pos); // get piece
-    if (!piece) return {}; // invalid move
-    
-    vector<Move> pseudoLegalMoves = piece->LegalMoves(*this, pos); // get pseudo legal moves
-    vector<Move> legalMoves; // initialize legal moves
+    if (!piece) return; // invalid move
     
-    for (const Move& move : pseudoLegalMoves) { // for each move
-        if (!wouldBeInCheckAfterMove(move)) { // if move is not in check
-            legalMoves.push_back(move); // add move to legal moves
+    LegalityMasks masks = computeLegalityMasks(piece->getColor()); // checkers and pins
+    if (masks.kingSq < 0) return; // a side without a king has no legal moves
+    if (bitCount(masks.checkers) > 1 && squareIndex(pos) != masks.kingSq) return; // double check, only the king may move
+    if (piece->getColor() == Color::WHITE) {
+        generateAll<Color::WHITE>(masks, squareBit(squareIndex(pos)), moves); // legal moves
+    } else {
+        generateAll<Color::BLACK>(masks, squareBit(squareIndex(pos)), moves); // legal moves
+    }
+}
+
+// checkers, check mask and pinned pieces of player
+LegalityMasks Board::computeLegalityMasks(Color player) const {
+    LegalityMasks masks; // masks
+    Bitboard king = getPieces(player, PieceType::KING); // king
+    if (!king) return masks; // no king
+    
+    Color enemy = oppositeColor(player); // enemy
+    masks.kingSq = lsb(king); // king square
+    masks.checkers = attackersTo(masks.kingSq, occupiedBB) & getOccupancy(enemy); // pieces giving check
+    
+    masks.checkMask = ~Bitboard(0); // not in check, every square
+    if (bitCount(masks.checkers) == 1) {
+        int checker = lsb(masks.checkers); // checking piece
+        masks.checkMask = Attacks::between(masks.kingSq, checker) | masks.checkers; // block or capture
+    }
+    
+    // enemy sliders that would hit the king on an empty board, with exactly one own piece in between
+    Bitboard queens = getPieces(enemy, PieceType::QUEEN); // enemy queens
+    Bitboard snipers = (Attacks::rook(masks.kingSq, 0) & (getPieces(enemy, PieceType::ROOK) | queens)) |
+                       (Attacks::bishop(masks.kingSq, 0) & (getPieces(enemy, PieceType::BISHOP) | queens)); // aligned sliders
+    while (snipers) {
+        Bitboard blockers = Attacks::between(masks.kingSq, popLsb(snipers)) & occupiedBB; // pieces in between
+        if (bitCount(blockers) == 1) {
+            masks.pinned |= blockers & getOccupancy(player); // own piece is pinned
+        }
+    }
+    return masks; // return masks
+}
+
+// add one move per promotion piece
+static void addPromotions(MoveList& moves, int from, int to, uint16_t captureFlag) {
+    moves.add(from, to, captureFlag | promotionFlag(PieceType::QUEEN)); // queen
+    moves.add(from, to, captureFlag | promotionFlag(PieceType::ROOK)); // rook
+    moves.add(from, to, captureFlag | promotionFlag(PieceType::BISHOP)); // bishop
+    moves.add(from, to, captureFlag | promotionFlag(PieceType::KNIGHT)); // knight
+}
+
+// append legal moves of Us's pieces on from, one specialised generator per piece type
+template <Color Us>
+void Board::generateAll(const LegalityMasks& masks, Bitboard from, MoveList& moves) const {
+    generate<Us, PieceType::PAWN>(masks, from, moves); // pawns
+    generate<Us, PieceType::KNIGHT>(masks, from, moves); // knights
+    generate<Us, PieceType::BISHOP>(masks, from, moves); // bishops
+    generate<Us, PieceType::ROOK>(masks, from, moves); // rooks
+    generate<Us, PieceType::QUEEN>(masks, from, moves); // queens
+    generate<Us, PieceType::KING>(masks, from, moves); // king
+}
+
+// append legal moves of Us's Type pieces on from. the piece type and side are
+// template arguments, so each instantiation calls its attack lookup directly
+// and needs no per-square dispatch through the Piece classes
+template <Color Us, PieceType Type>
+void Board::generate(const LegalityMasks& masks, Bitboard from, MoveList& moves) const {
+    if constexpr (Type == PieceType::PAWN) {
+        generatePawns<Us>(masks, from, moves); // pawns move, capture and promote differently
+    } else if constexpr (Type == PieceType::KING) {
+        if (from & squareBit(masks.kingSq)) generateKing<Us>(masks, moves); // king checks its own targets
+    } else {
+        constexpr Color Them = (Us == Color::WHITE) ? Color::BLACK : Color::WHITE; // enemy
+        Bitboard pieces = getPieces(Us, Type) & from; // pieces to move
+        Bitboard enemies = getOccupancy(Them); // enemy pieces
+        Bitboard open = ~getOccupancy(Us) & masks.checkMask; // squares not holding own pieces that resolve any check
+        while (pieces) {
+            int sq = popLsb(pieces); // from square
+            Bitboard targets; // reachable squares
+            if constexpr (Type == PieceType::KNIGHT) {
+                targets = Attacks::knight(sq);
+            } else if constexpr (Type == PieceType::BISHOP) {
+                targets = Attacks::bishop(sq, occupiedBB);
+            } else if constexpr (Type == PieceType::ROOK) {
+                targets = Attacks::rook(sq, occupiedBB);
+            } else {
+                targets = Attacks::queen(sq, occupiedBB);
+            }
+            targets &= open; // legal targets
+            if (masks.pinned & squareBit(sq)) {
+                targets &= Attacks::line(masks.kingSq, sq); // pinned pieces stay on the pin line
+            }
+            while (targets) {
+                int to = popLsb(targets); // target square
+                moves.add(sq, to, (enemies & squareBit(to)) ? MOVE_CAPTURE : MOVE_QUIET); // add move
+            }
+        }
+    }
+}
+
+// append legal moves of Us's pawns on from
+template <Color Us>
+void Board::generatePawns(const LegalityMasks& masks, Bitboard from, MoveList& moves) const {
+    constexpr Color Them = (Us == Color::WHITE) ? Color::BLACK : Color::WHITE; // enemy
+    constexpr int PUSH = (Us == Color::WHITE) ? 8 : -8; // one rank forward
+    constexpr Bitboard START_RANK = (Us == Color::WHITE) ? RANK_1_BB << 8 : RANK_8_BB >> 8; // double push rank
+    constexpr Bitboard PROMOTION_RANK = (Us == Color::WHITE) ? RANK_8_BB : RANK_1_BB; // last rank
+    
+    Bitboard pawns = getPieces(Us, PieceType::PAWN) & from; // pawns to move
+    Bitboard enemies = getOccupancy(Them); // enemy pieces
+    while (pawns) {
+        int sq = popLsb(pawns); // from square
+        Bitboard allowed = masks.checkMask; // target squares that resolve any check
+        if (masks.pinned & squareBit(sq)) {
+            allowed &= Attacks::line(masks.kingSq, sq); // pinned pawns stay on the pin line
+        }
+        
+        int to = sq + PUSH; // square in front
+        if (!(occupiedBB & squareBit(to))) {
+            if (allowed & squareBit(to)) {
+                if (PROMOTION_RANK & squareBit(to)) {
+                    addPromotions(moves, sq, to, MOVE_QUIET); // promote
+                } else {
+                    moves.add(sq, to, MOVE_QUIET); // push
+                }
+            }
+            int jump = to + PUSH; // two squares in front
+            if ((START_RANK & squareBit(sq)) && !(occupiedBB & squareBit(jump)) && (allowed & squareBit(jump))) {
+                moves.add(sq, jump, MOVE_DOUBLE_PUSH); // double push
+            }
+        }
+        
+        Bitboard captures = Attacks::pawn(Us, sq) & enemies & allowed; // legal captures
+        while (captures) {
+            int target = popLsb(captures); // captured square
+            if (PROMOTION_RANK & squareBit(target)) {
+                addPromotions(moves, sq, target, MOVE_CAPTURE); // capture and promote
+            } else {
+                moves.add(sq, target, MOVE_CAPTURE); // capture
+            }
+        }
+        
+        if (enPassantTarget.isValid() && (Attacks::pawn(Us, sq) & squareBit(squareIndex(enPassantTarget)))) {
+            int target = squareIndex(enPassantTarget); // landing square
+            Bitboard captured = squareBit(target - PUSH); // pawn taken, beside the mover
+            // the captured pawn may be the checker, so either square can resolve a check
+            if (masks.checkMask & (squareBit(target) | captured)) {
+                // two pawns leave the rank at once, so look for sliders through the new occupancy
+                Bitboard occupied = (occupiedBB ^ squareBit(sq) ^ captured) | squareBit(target); // after the capture
+                Bitboard queens = getPieces(Them, PieceType::QUEEN); // enemy queens
+                if (!(Attacks::rook(masks.kingSq, occupied) & (getPieces(Them, PieceType::ROOK) | queens)) &&
+                    !(Attacks::bishop(masks.kingSq, occupied) & (getPieces(Them, PieceType::BISHOP) | queens))) {
+                    moves.add(sq, target, MOVE_EN_PASSANT); // en passant
+                }
+            }
+        }
+    }
+}
+
+// append legal moves of Us's king
+template <Color Us>
+void Board::generateKing(const LegalityMasks& masks, MoveList& moves) const {
+    constexpr Color Them = (Us == Color::WHITE) ? Color::BLACK : Color::WHITE; // enemy
+    int sq = masks.kingSq; // king square
+    Bitboard enemies = getOccupancy(Them); // enemy pieces
+    Bitboard targets = Attacks::king(sq) & ~getOccupancy(Us); // adjacent squares not holding own pieces
+    while (targets) {
+        int to = popLsb(targets); // target square
+        // looked up without the king so it cannot hide behind itself
+        if (!(attackersTo(to, occupiedBB ^ squareBit(sq)) & enemies)) {
+            moves.add(sq, to, (enemies & squareBit(to)) ? MOVE_CAPTURE : MOVE_QUIET); // add move
         }
     }
     
-    return legalMoves; // get legal moves
+    // castling checks every square the king crosses
+    if (castle(Us, true)) {
+        moves.add(sq, sq + 2, MOVE_KING_CASTLE); // kingside
+    }
+    if (castle(Us, false)) {
+        moves.add(sq, sq - 2, MOVE_QUEEN_CASTLE); // queenside
+    }
+}
+
+// unpack a packed move using the piece on its from square
+Move Board::toMove(PackedMove move) const {
+    const Piece* piece = getPiece(squareToPosition(move.from())); // moving piece
+    return move.toMove(piece ? piece->getType() : PieceType::PAWN); // unpack move
+}
+
+// unpack a move list
+vector<Move> Board::toMoves(const MoveList& moves) const {
+    vector<Move> result; // moves
+    result.reserve(moves.size()); // reserve space
+    for (PackedMove move : moves) {
+        result.push_back(toMove(move)); // unpack move
+    }
+    return result; // return moves
 }
 
 // display
@@ -323,19 +660,14 @@ std::ostream& operator<<(std::ostream& os, const Board& board) {
 
 // find king
 Position Board::findKing(Color player) const {
-    for (int rowNum = 0; rowNum < 8; ++rowNum) { // initialize squares
-        for (int colNum = 0; colNum < 8; ++colNum) { // initialize squares
-            const Piece* piece = getPiece(rowNum, colNum); // get piece
-            if (piece && piece->getType() == PieceType::KING && piece->getColor() == player) { // if piece is not empty and type is king and color is player
-                return Position(rowNum, colNum); // return position
-            }
-        }
-    }
-    return Position(-1, -1); // invalid move
+    Bitboard kings = getPieces(player, PieceType::KING); // king mask
+    if (!kings) return Position(-1, -1); // no king
+    return squareToPosition(lsb(kings)); // return position
 }
 
 // is square attacked
 bool Board::isSquareAttacked(const Position& pos, Color byPlayer) const {
+    STATS_SCOPE(StatId::SQUARE_ATTACKED);
     return isSquareAttackedByPawn(pos, byPlayer) || // is square attacked by pawn
            isSquareAttackedByRook(pos, byPlayer) || // is square attacked by rook
            isSquareAttackedByBishop(pos, byPlayer) || // is square attacked by bishop
@@ -344,155 +676,57 @@ bool Board::isSquareAttacked(const Position& pos, Color byPlayer) const {
            isSquareAttackedByKing(pos, byPlayer); // is square attacked by king
 }
 
+// pieces of both colors attacking sq through occupied
+Bitboard Board::attackersTo(int sq, Bitboard occupied) const {
+    const auto& white = pieceBB[colorIndex(Color::WHITE)]; // white pieces
+    const auto& black = pieceBB[colorIndex(Color::BLACK)]; // black pieces
+    Bitboard rooks = white[pieceIndex(PieceType::ROOK)] | black[pieceIndex(PieceType::ROOK)] |
+                     white[pieceIndex(PieceType::QUEEN)] | black[pieceIndex(PieceType::QUEEN)]; // straight sliders
+    Bitboard bishops = white[pieceIndex(PieceType::BISHOP)] | black[pieceIndex(PieceType::BISHOP)] |
+                       white[pieceIndex(PieceType::QUEEN)] | black[pieceIndex(PieceType::QUEEN)]; // diagonal sliders
+    return (Attacks::pawn(Color::BLACK, sq) & white[pieceIndex(PieceType::PAWN)]) | // white pawns
+           (Attacks::pawn(Color::WHITE, sq) & black[pieceIndex(PieceType::PAWN)]) | // black pawns
+           (Attacks::knight(sq) & (white[pieceIndex(PieceType::KNIGHT)] | black[pieceIndex(PieceType::KNIGHT)])) | // knights
+           (Attacks::king(sq) & (white[pieceIndex(PieceType::KING)] | black[pieceIndex(PieceType::KING)])) | // kings
+           (Attacks::rook(sq, occupied) & rooks) | // rooks and queens
+           (Attacks::bishop(sq, occupied) & bishops); // bishops and queens
+}
+
 // is square attacked by pawn
 bool Board::isSquareAttackedByPawn(const Position& pos, Color byPlayer) const {
-    int attackDir; // initialize attack direction
-    if (byPlayer == Color::WHITE) { // if player is white   
-        attackDir = 1; // set attack direction to 1
-    } else {
-        attackDir = -1; // set attack direction to -1
-    }
-    
-    Position leftAttack(pos.r - attackDir, pos.c - 1); // left attack
-    Position rightAttack(pos.r - attackDir, pos.c + 1); // right attack
-    
-    if (leftAttack.isValid()) {
-        const Piece* piece = getPiece(leftAttack); // get piece
-        if (piece && piece->getType() == PieceType::PAWN && piece->getColor() == byPlayer) { // if piece is not empty and type is pawn and color is player
-            return true; // return true
-        }
-    }
-    if (rightAttack.isValid()) {
-        const Piece* piece = getPiece(rightAttack); // get piece
-        if (piece && piece->getType() == PieceType::PAWN && piece->getColor() == byPlayer) { // if piece is not empty and type is pawn and color is player
-            return true; // return true
-        }
-    }
-    
-    return false; // return false
+    // a pawn of byPlayer attacks pos exactly when a pawn of the other color on pos would attack it
+    return Attacks::pawn(oppositeColor(byPlayer), squareIndex(pos)) & getPieces(byPlayer, PieceType::PAWN);
 }
 
 // is square attacked by rook
 bool Board::isSquareAttackedByRook(const Position& pos, Color byPlayer) const {
-    const int directions[4][2] = {{0, 1}, {0, -1}, {1, 0}, {-1, 0}}; // directions
-    
-    for (int dirNum = 0; dirNum < 4; dirNum++) {
-        int rowDir = directions[dirNum][0]; // row direction
-        int colDir = directions[dirNum][1]; // column direction
-        
-        for (int dist = 1; dist < 8; dist++) {
-            Position checkPos(pos.r + dist * rowDir, pos.c + dist * colDir); // check position
-            if (!checkPos.isValid()) break; // if check position is invalid
-            
-            const Piece* piece = getPiece(checkPos); // get piece
-            if (piece) {
-                if (piece->getColor() == byPlayer && piece->getType() == PieceType::ROOK) {
-                    return true; // return true
-                }
-                break; // break
-            }
-        }
-    }
-    
-    return false; // return false
+    return Attacks::rook(squareIndex(pos), occupiedBB) & getPieces(byPlayer, PieceType::ROOK); // rooks with a clear line
 }
 
 // is square attacked by bishop
 bool Board::isSquareAttackedByBishop(const Position& pos, Color byPlayer) const {
-    const int directions[4][2] = {{1, 1}, {1, -1}, {-1, 1}, {-1, -1}}; // directions    
-    
-    for (int dirNum = 0; dirNum < 4; dirNum++) {
-        int rowDir = directions[dirNum][0]; // row direction
-        int colDir = directions[dirNum][1]; // column direction
-        
-        for (int dist = 1; dist < 8; dist++) {
-            Position checkPos(pos.r + dist * rowDir, pos.c + dist * colDir); // check position
-            if (!checkPos.isValid()) break; // if check position is invalid
-            
-            const Piece* piece = getPiece(checkPos); // get piece
-            if (piece) {
-                if (piece->getColor() == byPlayer && piece->getType() == PieceType::BISHOP) {
-                    return true; // return true
-                }
-                break; // break
-            }
-        }
-    }
-    
-    return false; // return false
+    return Attacks::bishop(squareIndex(pos), occupiedBB) & getPieces(byPlayer, PieceType::BISHOP); // bishops with a clear diagonal
 }
 
 // is square attacked by queen
 bool Board::isSquareAttackedByQueen(const Position& pos, Color byPlayer) const {
-    const int directions[8][2] = { // directions
-        {0, 1}, {0, -1}, {1, 0}, {-1, 0}, // directions
-        {1, 1}, {1, -1}, {-1, 1}, {-1, -1} // directions
-    };
-    
-    for (int d = 0; d < 8; d++) {
-        int rowDir = directions[d][0]; // row direction
-        int colDir = directions[d][1]; // column direction
-        
-        for (int dist = 1; dist < 8; dist++) {
-            Position checkPos(pos.r + dist * rowDir, pos.c + dist * colDir); // check position
-            if (!checkPos.isValid()) break; // if check position is invalid
-            
-            const Piece* piece = getPiece(checkPos); // get piece
-            if (piece) {
-                if (piece->getColor() == byPlayer && piece->getType() == PieceType::QUEEN) {
-                    return true; // return true
-                }
-                break; // break
-            }
-        }
-    }
-    
-    return false; // return false
+    return Attacks::queen(squareIndex(pos), occupiedBB) & getPieces(byPlayer, PieceType::QUEEN); // queens with a clear line
 }
 
 // is square attacked by knight
 bool Board::isSquareAttackedByKnight(const Position& pos, Color byPlayer) const {
-    const int knightMoves[8][2] = {
-        {2, 1}, {2, -1}, {-2, 1}, {-2, -1}, // knight moves
-        {1, 2}, {1, -2}, {-1, 2}, {-1, -2} // knight moves
-    };
-    
-    for (int moveNum = 0; moveNum < 8; moveNum++) {
-        Position knightPos(pos.r + knightMoves[moveNum][0], pos.c + knightMoves[moveNum][1]); // knight position
-        if (knightPos.isValid()) { // if knight position is valid
-            const Piece* piece = getPiece(knightPos); // get piece
-            if (piece && piece->getType() == PieceType::KNIGHT && piece->getColor() == byPlayer) {
-                return true; // return true
-            }
-        }
-    }
-    
-    return false;
+    return Attacks::knight(squareIndex(pos)) & getPieces(byPlayer, PieceType::KNIGHT); // knights a knight jump away
 }
 
 // is square attacked by king
 bool Board::isSquareAttackedByKing(const Position& pos, Color byPlayer) const {
-    const int kingMoves[8][2] = {
-        {0, 1}, {0, -1}, {1, 0}, {-1, 0}, // king moves
-        {1, 1}, {1, -1}, {-1, 1}, {-1, -1} // king moves
-    };
-    
-    for (int moveNum = 0; moveNum < 8; moveNum++) {
-        Position kingPos(pos.r + kingMoves[moveNum][0], pos.c + kingMoves[moveNum][1]); // king position
-        if (kingPos.isValid()) { // if king position is valid
-            const Piece* piece = getPiece(kingPos); // get piece
-            if (piece && piece->getType() == PieceType::KING && piece->getColor() == byPlayer) {
-                return true; // return true
-            }
-        }
-    }
-    
-    return false;
+    return Attacks::king(squareIndex(pos)) & getPieces(byPlayer, PieceType::KING); // king on an adjacent square
 }
 
 // switch player
 void Board::switchPlayer() {
     currentPlayer = oppositeColor(currentPlayer); // switch player
+    zobristKey ^= Zobrist::side(); // hash side to move
     if (currentPlayer == Color::WHITE) { // if current player is white
         fullmoveNumber++; // increment fullmove number
     }
@@ -500,6 +734,8 @@ void Board::switchPlayer() {
 
 // notify observers
 void Board::notifyObservers() {
+    STATS_SCOPE(StatId::NOTIFY_OBSERVERS);
+    TRACE_SCOPE("notify observers");
     if (isCheckmate(currentPlayer)) { // if current player is checkmate
         gameState = (currentPlayer == Color::WHITE) ? 
             GameState::CHECKMATE_BLACK_WINS : GameState::CHECKMATE_WHITE_WINS; // set game state
@@ -509,6 +745,10 @@ void Board::notifyObservers() {
         gameState = GameState::DRAW_STALEMATE; // set game state
         
         notifyDraw("Stalemate"); // notify draw
+    } else if (isThreefoldRepetition()) { // if position occurred three times
+        gameState = GameState::DRAW_REPETITION; // set game state
+        
+        notifyDraw("Threefold repetition"); // notify draw
     } else if (isInCheck(currentPlayer)) { // if current player is in check
         gameState = GameState::CHECK; // set game state
         
@@ -521,98 +761,13 @@ void Board::notifyObservers() {
 
 // execute move
 bool Board::executeMove(const Move& move) {
-    const Piece* piece = getPiece(move.init); // get piece
-    if (!piece) return false; // if piece is empty
-    
-    if (move.isCast) { // if move is castling
-        bool kingSide = (move.finalpos.c > move.init.c); // if king side
-        
-        int RookCol; // initialize rook from column
-        if (kingSide) { // if king side
-            RookCol = 7; // rook from column
-        } else { // if queen side
-            RookCol = 0; // rook from column
-        }
-        int RookToCol; // initialize rook to column
-        if (kingSide) { // if king side
-            RookToCol = 5; // rook to column
-        } else { // if queen side
-            RookToCol = 3; // rook to column
-        }
-        
-        Position rookFrom(move.init.r, RookCol); // rook from position
-        Position rookTo(move.init.r, RookToCol); // rook to position
-        
-        // Execute castling
-        auto king = std::move(squares[move.init.r][move.init.c]); // get piece
-        squares[move.init.r][move.init.c] = nullptr; // set piece
-        squares[move.finalpos.r][move.finalpos.c] = std::move(king); // set piece
-        
-        auto rook = std::move(squares[rookFrom.r][rookFrom.c]); // get piece
-        squares[rookFrom.r][rookFrom.c] = nullptr; // set piece
-        squares[rookTo.r][rookTo.c] = std::move(rook); // set piece
-        
-        return true; // return true
-    }
-    
-    if (move.isEnp) { // if move is en passant
-        const Piece* movingPiece = getPiece(move.init); // get piece
-        if (!movingPiece) return false; // if piece is empty
-        
-        Position capturedPawnPos; // captured pawn position
-        if (movingPiece->getColor() == Color::WHITE) { // if moving piece is white
-            capturedPawnPos = Position(move.finalpos.r - 1, move.finalpos.c); // captured pawn position
-        } else { // if moving piece is black
-            capturedPawnPos = Position(move.finalpos.r + 1, move.finalpos.c); // captured pawn position
-        }
-        
-        if (capturedPawnPos.isValid()) {
-            squares[capturedPawnPos.r][capturedPawnPos.c] = nullptr; // set piece to nullptr
-        }
-        
-        auto pawn = std::move(squares[move.init.r][move.init.c]); // get piece
-        pawn->setHasMoved(true); // set has moved
-        squares[move.finalpos.r][move.finalpos.c] = std::move(pawn); // set piece
-        
-        return true; // return true
-    }
-    
-    auto movingPiece = std::move(squares[move.init.r][move.init.c]); // get piece
-    if (!movingPiece) return false; // if piece is empty
-    
-    movingPiece->setHasMoved(true); // set has moved
-    
-    if (move.isProm) { // if move is promotion
-        movingPiece = PieceFactory::initPiece(move.pProm, movingPiece->getColor()); // init piece
-    }
-    squares[move.finalpos.r][move.finalpos.c] = std::move(movingPiece); // set piece
+    if (!getPiece(move.init)) return false; // if piece is empty
     
+    MoveUndo undo; // undo record
+    makeMove(move, undo); // make move
     return true;
 }
 
-// would be in check after move
-bool Board::wouldBeInCheckAfterMove(const Move& move) const {
-    const Piece* movingPiece = getPiece(move.init); // get piece
-    if (!movingPiece) return false; // if piece is empty
-    
-    Color movingPlayerColor = movingPiece->getColor(); // get moving player color
-    
-    auto boardCopy = createCopy(); // create copy
-    
-    if (!boardCopy->applyMoveToBoard(move)) { // if move is not valid
-        return true; // return true
-    }
-    
-    Position kingPos = boardCopy->findKing(movingPlayerColor); // find king
-    if (!kingPos.isValid()) { // if king position is invalid
-        return true; // return true
-    }
-    
-    bool inCheck = boardCopy->isSquareAttacked(kingPos, oppositeColor(movingPlayerColor)); // is square attacked
-    
-    return inCheck; // return in check
-}
-
 // is insufficient material
 bool Board::isInsufficientMaterial() const {
     return false; // return false
@@ -625,69 +780,142 @@ bool Board::is50MoveRule() const {
 
 // is threefold repetition
 bool Board::isThreefoldRepetition() const {
+    int limit = min<int>(halfmoveClock, keyHistory.size()); // nothing before the last irreversible move can repeat
+    int repeats = 0; // earlier occurrences
+    
+    // same side to move only, so step back two plies at a time
+    for (int ply = 4; ply <= limit; ply += 2) {
+        if (keyHistory[keyHistory.size() - ply] == zobristKey) {
+            if (++repeats == 2) return true; // third occurrence
+        }
+    }
     return false;
 }
 
-// apply move to board
-bool Board::applyMoveToBoard(const Move& move) {
-    const Piece* piece = getPiece(move.init); // get piece
-    if (!piece) return false; // if piece is empty
-    
-    if (move.isCast) { // if move is castling
-        bool kingSide = (move.finalpos.c > move.init.c); // if king side
-        
-        int RookCol; // initialize rook from column
-        if (kingSide) { // if king side
-            RookCol = 7; // rook from column
-        } else { // if queen side
-            RookCol = 0; // rook from column
-        }
-        int RookToCol; // initialize rook to column
-        if (kingSide) { // if king side
-            RookToCol = 5; // rook to column
-        } else { // if queen side
-            RookToCol = 3; // rook to column
+// is repetition
+bool Board::isRepetition() const {
+    int limit = min<int>(halfmoveClock, keyHistory.size()); // nothing before the last irreversible move can repeat
+    for (int ply = 4; ply <= limit; ply += 2) {
+        if (keyHistory[keyHistory.size() - ply] == zobristKey) {
+            return true; // earlier occurrence
         }
-        
-        Position rookFrom(move.init.r, RookCol); // rook from position
-        Position rookTo(move.init.r, RookToCol); // rook to position
-        
-        auto king = std::move(squares[move.init.r][move.init.c]); // get piece
-        king->setHasMoved(true); // set has moved
-        squares[move.finalpos.r][move.finalpos.c] = std::move(king); // set piece
-        
-        auto rook = std::move(squares[rookFrom.r][rookFrom.c]); // get piece
-        rook->setHasMoved(true); // set has moved
-        squares[rookTo.r][rookTo.c] = std::move(rook); // set piece
-        
-        return true; // return true
     }
-    
-    if (move.isEnp) { // if move is en passant
-        Position capturedPawnPos; // captured pawn position
-        if (piece->getColor() == Color::WHITE) { // if piece is white
-            capturedPawnPos = Position(move.finalpos.r - 1, move.finalpos.c); // captured pawn position
-        } else { // if piece is black
-            capturedPawnPos = Position(move.finalpos.r + 1, move.finalpos.c); // captured pawn position
-        }
+    return false;
+}
+
+// castling rights kept after a piece leaves or lands on the square
+static uint8_t castlingRightsMask(int sq) {
+    if (sq == squareIndex(0, 4)) return CASTLE_ALL & ~(CASTLE_WHITE_KINGSIDE | CASTLE_WHITE_QUEENSIDE); // white king
+    if (sq == squareIndex(0, 7)) return CASTLE_ALL & ~CASTLE_WHITE_KINGSIDE; // white kingside rook
+    if (sq == squareIndex(0, 0)) return CASTLE_ALL & ~CASTLE_WHITE_QUEENSIDE; // white queenside rook
+    if (sq == squareIndex(7, 4)) return CASTLE_ALL & ~(CASTLE_BLACK_KINGSIDE | CASTLE_BLACK_QUEENSIDE); // black king
+    if (sq == squareIndex(7, 7)) return CASTLE_ALL & ~CASTLE_BLACK_KINGSIDE; // black kingside rook
+    if (sq == squareIndex(7, 0)) return CASTLE_ALL & ~CASTLE_BLACK_QUEENSIDE; // black queenside rook
+    return CASTLE_ALL;
+}
+
+// make move
+void Board::makeMove(const Move& move, MoveUndo& undo) {
+    makeMove(PackedMove(move), undo); // make packed move
+}
+
+// make packed move
+void Board::makeMove(PackedMove move, MoveUndo& undo) {
+    undo.captured = nullptr; // records are reused, castling captures nothing
+    undo.enPassantTarget = enPassantTarget; // save en passant target
+    undo.halfmoveClock = halfmoveClock; // save halfmove clock
+    undo.castlingRights = castlingRights; // save castling rights
+    undo.zobristKey = zobristKey; // save Zobrist key
+    keyHistory.push_back(zobristKey); // push position key
+    zobristKey ^= enPassantKey(); // hash old en passant file out
+    
+    int from = move.from(); // from square
+    int to = move.to(); // to square
+    
+    const Piece* piece = liftPiece(from); // get piece
+    PieceType type = piece->getType(); // moving piece type
+    
+    if (move.isCastle()) { // if move is castling
+        bool kingSide = (move.flags() == MOVE_KING_CASTLE); // if king side
+        int rookFrom = kingSide ? from + 3 : from - 4; // rook from square
+        int rookTo = kingSide ? from + 1 : from - 1; // rook to square
         
-        if (capturedPawnPos.isValid()) {
-            squares[capturedPawnPos.r][capturedPawnPos.c] = nullptr; // set piece to nullptr
+        placePiece(rookTo, liftPiece(rookFrom)); // move rook
+    } else {
+        int capturedSq = to; // captured square
+        if (move.isEnPassant()) {
+            capturedSq = squareIndex(from / 8, to % 8); // captured pawn sits beside the mover
         }
+        undo.captured = liftPiece(capturedSq); // remember captured piece
     }
     
-    auto movingPiece = std::move(squares[move.init.r][move.init.c]); // get piece
-    if (!movingPiece) return false; // if piece is empty
+    if (move.isPromotion()) { // if move is promotion
+        piece = PieceFactory::initPiece(move.promotion(), piece->getColor()); // shared promoted piece
+    }
+    placePiece(to, piece); // set piece
     
-    movingPiece->setHasMoved(true); // set has moved
+    zobristKey ^= Zobrist::castling(castlingRights); // hash old castling rights out
+    castlingRights &= castlingRightsMask(from) & castlingRightsMask(to); // update castling rights
+    zobristKey ^= Zobrist::castling(castlingRights); // hash new castling rights in
     
-    if (move.isProm) { // if move is promotion
-        movingPiece = PieceFactory::initPiece(move.pProm, movingPiece->getColor()); // init piece       
+    if (type == PieceType::PAWN || undo.captured) { // irreversible move
+        halfmoveClock = 0; // reset halfmove clock
+    } else {
+        halfmoveClock++; // increment halfmove clock
     }
     
-    squares[move.finalpos.r][move.finalpos.c] = std::move(movingPiece); // set piece
+    updateEnPassantTarget(move); // update en passant target
+    switchPlayer(); // switch player
+    zobristKey ^= enPassantKey(); // hash new en passant file in
+}
+
+// room for plies more made moves without reallocating. makeMove pushes one
+// position key per move, so a search that reserves its depth up front never
+// grows the history while it runs
+void Board::reserveHistory(int plies) {
+    keyHistory.reserve(keyHistory.size() + plies); // reserve key history
+}
+
+// unmake move
+void Board::unmakeMove(const Move& move, MoveUndo& undo) {
+    unmakeMove(PackedMove(move), undo); // unmake packed move
+}
+
+// unmake packed move
+void Board::unmakeMove(PackedMove move, MoveUndo& undo) {
+    if (currentPlayer == Color::WHITE) { // undoing a black move
+        fullmoveNumber--; // decrement fullmove number
+    }
+    currentPlayer = oppositeColor(currentPlayer); // switch player back
     
-    return true; // return true
+    int from = move.from(); // from square
+    int to = move.to(); // to square
+    
+    const Piece* piece = liftPiece(to); // get piece
+    if (move.isPromotion()) { // if move is promotion
+        piece = PieceFactory::initPiece(PieceType::PAWN, piece->getColor()); // restore pawn
+    }
+    placePiece(from, piece); // set piece
+    
+    if (move.isCastle()) { // if move is castling
+        bool kingSide = (move.flags() == MOVE_KING_CASTLE); // if king side
+        int rookFrom = kingSide ? from + 3 : from - 4; // rook from square
+        int rookTo = kingSide ? from + 1 : from - 1; // rook to square
+        
+        placePiece(rookFrom, liftPiece(rookTo)); // move rook back
+    } else if (undo.captured) {
+        int capturedSq = to; // captured square
+        if (move.isEnPassant()) {
+            capturedSq = squareIndex(from / 8, to % 8); // captured pawn sits beside the mover
+        }
+        placePiece(capturedSq, undo.captured); // restore captured piece
+    }
+    
+    enPassantTarget = undo.enPassantTarget; // restore en passant target
+    halfmoveClock = undo.halfmoveClock; // restore halfmove clock
+    castlingRights = undo.castlingRights; // restore castling rights
+    zobristKey = undo.zobristKey; // restore Zobrist key
+    keyHistory.pop_back(); // pop position key
 }
 
 // create move
@@ -746,8 +974,14 @@ bool Board::castle(Color player, bool kingSide) const {
     Position kingPos = findKing(player); // find king
     if (!kingPos.isValid()) return false; // if king position is invalid
     
-    const Piece* king = getPiece(kingPos); // get piece
-    if (!king || king->getHasMoved()) return false;
+    uint8_t right; // castling right needed
+    if (player == Color::WHITE) { // if player is white
+        right = kingSide ? CASTLE_WHITE_KINGSIDE : CASTLE_WHITE_QUEENSIDE; // white right
+    } else { // if player is black
+        right = kingSide ? CASTLE_BLACK_KINGSIDE : CASTLE_BLACK_QUEENSIDE; // black right
+    }
+    int homeRank = (player == Color::WHITE) ? 0 : 7; // home rank
+    if (!(castlingRights & right) || kingPos != Position(homeRank, 4)) return false; // right lost or king off its home square
     
     if (isInCheck(player)) return false; // if player is in check
     
@@ -767,7 +1001,7 @@ bool Board::castle(Color player, bool kingSide) const {
     Position rookPos(kingPos.r, rookCol); // rook position
     const Piece* rook = getPiece(rookPos); // get piece
     
-    if (!rook || rook->getType() != PieceType::ROOK || rook->getHasMoved()) { // if rook is empty or rook is not rook or rook has moved
+    if (!rook || rook->getType() != PieceType::ROOK || rook->getColor() != player) { // if rook is empty or rook is not an own rook
         return false; // return false
     }
     
@@ -825,16 +1059,11 @@ bool Board::enpassant(const Position& from, const Position& to) const {
 }
 
 // update en passant target
-void Board::updateEnPassantTarget(const Move& move) {
+void Board::updateEnPassantTarget(PackedMove move) {
     enPassantTarget = Position(-1, -1); // en passant target
     
-    if (move.pType == PieceType::PAWN) { // if piece is pawn
-        int distance = abs(move.finalpos.r - move.init.r); // distance
-        
-        if (distance == 2) { // if distance is 2
-            int targetRank = (move.init.r + move.finalpos.r) / 2; // target rank
-            enPassantTarget = Position(targetRank, move.finalpos.c); // en passant target
-        }
+    if (move.isDoublePush()) { // if pawn moved two squares
+        enPassantTarget = squareToPosition((move.from() + move.to()) / 2); // en passant target
     }
 }
 
@@ -874,25 +1103,25 @@ string Board::toFEN() const {
     string castleStr = ""; // castling
     
     const Piece* whiteKing = getPiece(0, 4); // get piece
-    if (whiteKing && whiteKing->getType() == PieceType::KING && !whiteKing->getHasMoved()) { // if white king is not empty and white king is king and white king has not moved
+    if (whiteKing && whiteKing->getType() == PieceType::KING) { // if white king is on its home square
         const Piece* kingsideRook = getPiece(0, 7); // get piece
-        if (kingsideRook && kingsideRook->getType() == PieceType::ROOK && !kingsideRook->getHasMoved()) { // if kingside rook is not empty and kingside rook is rook and kingside rook has not moved
+        if ((castlingRights & CASTLE_WHITE_KINGSIDE) && kingsideRook && kingsideRook->getType() == PieceType::ROOK) { // if kingside right is held and the rook is home
             castleStr += 'K'; // add 'K' to castling
         }
         const Piece* queensideRook = getPiece(0, 0); // get piece
-        if (queensideRook && queensideRook->getType() == PieceType::ROOK && !queensideRook->getHasMoved()) { // if queenside rook is not empty and queenside rook is rook and queenside rook has not moved
+        if ((castlingRights & CASTLE_WHITE_QUEENSIDE) && queensideRook && queensideRook->getType() == PieceType::ROOK) { // if queenside right is held and the rook is home
             castleStr += 'Q'; // add 'Q' to castling
         }
     }
     
     const Piece* blackKing = getPiece(7, 4); // get piece
-    if (blackKing && blackKing->getType() == PieceType::KING && !blackKing->getHasMoved()) { // if black king is not empty and black king is king and black king has not moved
+    if (blackKing && blackKing->getType() == PieceType::KING) { // if black king is on its home square
         const Piece* rookBlackKingside = getPiece(7, 7); // get piece
-        if (rookBlackKingside && rookBlackKingside->getType() == PieceType::ROOK && !rookBlackKingside->getHasMoved()) { // if kingside rook is not empty and kingside rook is rook and kingside rook has not moved
+        if ((castlingRights & CASTLE_BLACK_KINGSIDE) && rookBlackKingside && rookBlackKingside->getType() == PieceType::ROOK) { // if kingside right is held and the rook is home
             castleStr += 'k'; // add 'k' to castling
         }
         const Piece* rookBlackQueenside = getPiece(7, 0); // get piece
-        if (rookBlackQueenside && rookBlackQueenside->getType() == PieceType::ROOK && !rookBlackQueenside->getHasMoved()) { // if queenside rook is not empty and queenside rook is rook and queenside rook has not moved
+        if ((castlingRights & CASTLE_BLACK_QUEENSIDE) && rookBlackQueenside && rookBlackQueenside->getType() == PieceType::ROOK) { // if queenside right is held and the rook is home
             castleStr += 'q'; // add 'q' to castling 
         }
     }
@@ -930,12 +1159,7 @@ bool Board::loadFromFEN(const string& fen) {
     
     if (partsVec.size() < 6) return false; // if parts size is less than 6
     
-    // Clear board
-    for (int rowNum = 0; rowNum < 8; ++rowNum) { // clear board
-        for (int colNum = 0; colNum < 8; ++colNum) { // clear board
-            squares[rowNum][colNum] = nullptr; // clear board
-        }
-    }
+    clear(); // clear board
     
     string piecePlacementStr = partsVec[0]; // piece placement string
     int rankNum = 7; // rank number
@@ -946,15 +1170,16 @@ bool Board::loadFromFEN(const string& fen) {
             rankNum--; // rank number
             fileNum = 0; // file number
         } else if (isdigit(c)) {
-            fileNum += c - '0' - 1; // advance file number
+            fileNum += c - '0'; // advance file number
         } else {
-            auto piece = PieceFactory::initPieceFromChar(c); // create piece
+            const Piece* piece = PieceFactory::initPieceFromChar(c); // shared piece
             if (piece) { // if piece is not empty
-                setPiece(Position(rankNum, fileNum), std::move(piece)); // set piece
+                setPiece(Position(rankNum, fileNum), piece); // set piece
             }
             fileNum++; // file number
         }
     }
+    if (!hasPossibleMaterial()) return false; // more moves than a move list holds
     
     if (partsVec[1] == "w") { // if parts[1] is "w"
         currentPlayer = Color::WHITE; // current player
@@ -966,52 +1191,11 @@ bool Board::loadFromFEN(const string& fen) {
     
     string castleStr = partsVec[2]; // castle string
     
-    bool whiteKingsideCastling = castleStr.find('K') != string::npos; // white kingside castling
-    bool whiteQueensideCastling = castleStr.find('Q') != string::npos; // white queenside castling
-    bool blackKingsideCastling = castleStr.find('k') != string::npos; // black kingside castling
-    bool blackQueensideCastling = castleStr.find('q') != string::npos; // black queenside castling
-        
-    const Piece* whiteKing = getPiece(0, 4); // get piece
-    if (whiteKing && whiteKing->getType() == PieceType::KING) { // if white king is not empty and white king is king
-        if (whiteKingsideCastling || whiteQueensideCastling) { // if white kingside castling or white queenside castling
-            const_cast<Piece*>(whiteKing)->setHasMoved(false); // set has moved
-        }
-    }
-        
-    const Piece* blackKing = getPiece(7, 4); // get piece
-    if (blackKing && blackKing->getType() == PieceType::KING) { // if black king is not empty and black king is king
-        if (blackKingsideCastling || blackQueensideCastling) { // if black kingside castling or black queenside castling
-            const_cast<Piece*>(blackKing)->setHasMoved(false); // set has moved
-        }
-    }
-        
-    if (whiteKingsideCastling) { // if white kingside castling
-        const Piece* rook = getPiece(0, 7); // get piece
-        if (rook && rook->getType() == PieceType::ROOK) { // if rook is not empty and rook is rook
-            const_cast<Piece*>(rook)->setHasMoved(false); // set has moved
-        }
-    }
-        
-    if (whiteQueensideCastling) { // if white queenside castling
-        const Piece* rook = getPiece(0, 0); // get piece
-        if (rook && rook->getType() == PieceType::ROOK) { // if rook is not empty and rook is rook
-            const_cast<Piece*>(rook)->setHasMoved(false); // set has moved
-        }
-    }
-        
-    if (blackKingsideCastling) { // if black kingside castling
-        const Piece* rook = getPiece(7, 7); // get piece
-        if (rook && rook->getType() == PieceType::ROOK) { // if rook is not empty and rook is rook
-            const_cast<Piece*>(rook)->setHasMoved(false); // set has moved
-        }
-    }
-        
-    if (blackQueensideCastling) { // if black queenside castling
-        const Piece* rook = getPiece(7, 0); // get piece
-        if (rook && rook->getType() == PieceType::ROOK) { // if rook is not empty and rook is rook
-            const_cast<Piece*>(rook)->setHasMoved(false); // set has moved
-        }
-    }
+    castlingRights = 0; // castling rights
+    if (castleStr.find('K') != string::npos) castlingRights |= CASTLE_WHITE_KINGSIDE; // white kingside castling
+    if (castleStr.find('Q') != string::npos) castlingRights |= CASTLE_WHITE_QUEENSIDE; // white queenside castling
+    if (castleStr.find('k') != string::npos) castlingRights |= CASTLE_BLACK_KINGSIDE; // black kingside castling
+    if (castleStr.find('q') != string::npos) castlingRights |= CASTLE_BLACK_QUEENSIDE; // black queenside castling
     
     if (partsVec[3] != "-") { // if parts[3] is not "-"
         enPassantTarget = Position::fromAlgebraic(partsVec[3]); // en passant position
@@ -1031,6 +1215,8 @@ bool Board::loadFromFEN(const string& fen) {
         fullmoveNumber = 1; // fullmove number
     }
     
+    keyHistory.clear(); // positions before the FEN are unknown
+    zobristKey = computeZobristKey(); // recompute Zobrist key
     gameState = GameState::PLAYING; // game state
     notifyObservers(); // notify observers
     
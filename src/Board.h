@@ -4,6 +4,9 @@
 #include "types.h"
 #include "Piece.h"
 #include "PieceFactory.h"
+#include "Bitboard.h"
+#include "Zobrist.h"
+#include "MoveList.h"
 #include <array>
 #include <vector>
 #include <memory>
@@ -11,30 +14,86 @@
 
 using namespace std;
 
+// castling rights
+const uint8_t CASTLE_WHITE_KINGSIDE = 1;
+const uint8_t CASTLE_WHITE_QUEENSIDE = 2;
+const uint8_t CASTLE_BLACK_KINGSIDE = 4;
+const uint8_t CASTLE_BLACK_QUEENSIDE = 8;
+const uint8_t CASTLE_ALL = 15;
+
 class Observer;
 
+// undo record filled by makeMove and consumed by unmakeMove
+struct MoveUndo {
+    const Piece* captured = nullptr; // captured piece, restored by unmake
+    Position enPassantTarget; // previous en passant target
+    int halfmoveClock = 0; // previous halfmove clock
+    uint8_t castlingRights = 0; // previous castling rights
+    uint64_t zobristKey = 0; // previous Zobrist key
+};
+
+// per-position data that lets the generator emit only legal moves
+struct LegalityMasks {
+    int kingSq = -1; // square of the side's king, -1 if it has none
+    Bitboard checkers = 0; // enemy pieces giving check
+    Bitboard checkMask = 0; // squares a non-king move must land on: everything, or block/capture squares when in single check
+    Bitboard pinned = 0; // own pieces pinned to the king
+};
+
+// legal moves and terminal state of one position, reused until the board changes
+struct PositionCache {
+    bool valid = false; // filled for the current placement
+    uint64_t key = 0; // Zobrist key of the cached position
+    Color player = Color::WHITE; // side the moves belong to
+    MoveList moves; // legal moves
+    bool inCheck = false; // player is in check
+    GameState state = GameState::PLAYING; // checkmate, stalemate, check or playing
+};
+
 // Board class
 class Board {
-    array<array<unique_ptr<Piece>, 8>, 8> squares; // squares
+    array<array<const Piece*, 8>, 8> squares; // shared pieces, null when empty
+    array<array<Bitboard, 6>, 2> pieceBB; // one mask per color and piece type
+    array<Bitboard, 2> colorBB; // occupancy per color
+    Bitboard occupiedBB; // occupancy of both colors
+    uint64_t zobristKey; // Zobrist key of the position
+    uint64_t pawnKey; // Zobrist key of the pawns alone
+    int midgameScore; // material and piece-square middlegame sum, white positive
+    int endgameScore; // material and piece-square endgame sum, white positive
+    int gamePhase; // non-pawn material left, PHASE_MAX at the start
     vector<Observer*> observers; // observers
     Color currentPlayer; // current player
     GameState gameState; // game state
     Position enPassantTarget; // en passant target
+    uint8_t castlingRights; // castling rights
     int halfmoveClock; // halfmove clock
     int fullmoveNumber; // fullmove number
     vector<Move> moveHistory; // move history
+    vector<uint64_t> keyHistory; // Zobrist keys of the positions before each made move
+    mutable PositionCache positionCache; // legal moves of the last position asked about
     
     bool executeMove(const Move& move); // execute move
-    bool wouldBeInCheckAfterMove(const Move& move) const; // would be in check after move
+    LegalityMasks computeLegalityMasks(Color player) const; // checkers, check mask and pinned pieces of player
+    template <Color Us> void generateAll(const LegalityMasks& masks, Bitboard from, MoveList& moves) const; // append legal moves of Us's pieces on from
+    template <Color Us, PieceType Type> void generate(const LegalityMasks& masks, Bitboard from, MoveList& moves) const; // append legal moves of Us's Type pieces on from
+    template <Color Us> void generatePawns(const LegalityMasks& masks, Bitboard from, MoveList& moves) const; // append legal moves of Us's pawns on from
+    template <Color Us> void generateKing(const LegalityMasks& masks, MoveList& moves) const; // append legal moves of Us's king
     void updateCastlingAvailability(); // update castling availability
     bool isPathClearForCastling(Color player, bool kingSide) const; // is path clear for castling
-    void updateEnPassantTarget(const Move& move); // update en passant target
+    void updateEnPassantTarget(PackedMove move); // update en passant target
     bool isInsufficientMaterial() const; // is insufficient material
     bool is50MoveRule() const; // is 50 move rule
     bool isThreefoldRepetition() const; // is threefold repetition
     Move createMove(const Position& from, const Position& to, PieceType promotion = PieceType::QUEEN) const; // create move
     bool isPromotion(const Move& move) const; // is promotion
     bool isCastling(const Move& move) const; // is castling
+    void placePiece(int sq, const Piece* piece); // place piece and update masks
+    const Piece* liftPiece(int sq); // lift piece and update masks
+    void clearMasks(); // clear masks
+    uint64_t enPassantKey() const; // en passant part of the Zobrist key
+    bool isCached(Color player) const { // cache holds player's moves in this position
+        return positionCache.valid && positionCache.key == zobristKey && positionCache.player == player;
+    }
     
 public:
     Board(); // constructor
@@ -61,24 +120,33 @@ public:
     
     const Piece* getPiece(const Position& pos) const; // get piece
     const Piece* getPiece(int row, int col) const; // get piece
-    void setPiece(const Position& pos, unique_ptr<Piece> piece); // set piece
+    void setPiece(const Position& pos, const Piece* piece); // set piece
     void removePiece(const Position& pos); // remove piece
     
     bool isInCheck(Color player) const; // is in check
     bool isCheckmate(Color player) const; // is checkmate
     bool isStalemate(Color player) const; // is stalemate
     bool isDraw() const; // is draw
+    bool isRepetition() const; // position occurred before since the last irreversible move
     Color getCurrentPlayer() const { return currentPlayer; } // get current player
-    void setCurrentPlayer(Color player) { currentPlayer = player; } // set current player
+    void setCurrentPlayer(Color player) { currentPlayer = player; zobristKey = computeZobristKey(); } // set current player
     GameState getGameState() const { return gameState; } // get game state
+    int getHalfmoveClock() const { return halfmoveClock; } // get halfmove clock
     const vector<Move>& getMoveHistory() const { return moveHistory; } // get move history
     
     void setup(); // setup
     void clear(); // clear
     bool isValidSetup() const; // is valid setup
+    bool hasPossibleMaterial() const; // piece counts could arise in a real game
     
     vector<Move> getAllLegalMoves(Color player) const; // get all legal moves
     vector<Move> getLegalMoves(const Position& pos) const; // get legal moves
+    const MoveList& getLegalMoveList(Color player) const; // legal moves, generated once per position
+    GameState getTerminalState(Color player) const; // checkmate, stalemate, check or playing, from the cache
+    void generateLegalMoves(Color player, MoveList& moves) const; // append legal moves without allocating
+    void generateLegalMoves(const Position& pos, MoveList& moves) const; // append legal moves of one piece
+    Move toMove(PackedMove move) const; // unpack a packed move using the piece on its from square
+    vector<Move> toMoves(const MoveList& moves) const; // unpack a move list
     
     bool castle(Color player, bool kingSide) const; // castle
     bool enpassant(const Position& from, const Position& to) const; // enpassant
@@ -88,6 +156,10 @@ public:
     
     Position findKing(Color player) const; // find king
     bool isSquareAttacked(const Position& pos, Color byPlayer) const; // is square attacked
+    Bitboard attackersTo(int sq, Bitboard occupied) const; // pieces of both colors attacking sq through occupied
+    Bitboard getPieces(Color player, PieceType type) const { return pieceBB[colorIndex(player)][pieceIndex(type)]; } // get piece mask
+    Bitboard getOccupancy(Color player) const { return colorBB[colorIndex(player)]; } // get color occupancy
+    Bitboard getOccupancy() const { return occupiedBB; } // get occupancy
     
     bool isSquareAttackedByPawn(const Position& pos, Color byPlayer) const; // is square attacked by pawn
     bool isSquareAttackedByRook(const Position& pos, Color byPlayer) const; // is square attacked by rook
@@ -101,7 +173,18 @@ public:
     string toFEN() const; // to FEN
     bool loadFromFEN(const string& fen); // load from FEN
     
-    bool applyMoveToBoard(const Move& move); // apply move to board
+    void makeMove(const Move& move, MoveUndo& undo); // make move in place
+    void unmakeMove(const Move& move, MoveUndo& undo); // take back a move made by makeMove
+    void makeMove(PackedMove move, MoveUndo& undo); // make packed move in place
+    void unmakeMove(PackedMove move, MoveUndo& undo); // take back a packed move made by makeMove
+    void reserveHistory(int plies); // room for plies more made moves without reallocating
+    uint8_t getCastlingRights() const { return castlingRights; } // get castling rights
+    uint64_t getZobristKey() const { return zobristKey; } // get Zobrist key
+    uint64_t getPawnKey() const { return pawnKey; } // get pawn structure key
+    int getMidgameScore() const { return midgameScore; } // middlegame sum, white positive
+    int getEndgameScore() const { return endgameScore; } // endgame sum, white positive
+    int getGamePhase() const { return gamePhase; } // non-pawn material phase
+    uint64_t computeZobristKey() const; // compute Zobrist key from scratch
 };
 
 // Observer class
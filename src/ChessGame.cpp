@@ -2,11 +2,20 @@
 #include <iostream>
 #include <sstream>
 #include "GraphicalDisplay.h"
+#include "Perft.h"
+#include "Search.h"
+#include "SEE.h"
+#include "Stats.h"
+#include "Trace.h"
 #include <cstdlib>
 #include <thread>
 #include <chrono>
 #include <random>
 #include <fstream>
+#include <iomanip>
+#include <cerrno>
+#include <poll.h>
+#include <unistd.h>
 
 using namespace std;
 
@@ -14,7 +23,7 @@ using namespace std;
 const int WINDOW_SIZE = 500;
     
 // constructor
-ChessGame::ChessGame(bool graphics, bool greenTiles, bool assignmentStyle) : gameActive(false), Setup(false), ifCustomSetup(false), useGraphics(graphics), ifGreenTiles(greenTiles), ifAssignmentStyle(assignmentStyle) {
+ChessGame::ChessGame(bool graphics, bool greenTiles, bool assignmentStyle) : quitRequested(false), gameActive(false), Setup(false), ifCustomSetup(false), useGraphics(graphics), ifGreenTiles(greenTiles), ifAssignmentStyle(assignmentStyle) {
     board = make_unique<Board>(); // board
     textDisplay = make_unique<TextDisplay>(cout, true, false, assignmentStyle);
     
@@ -43,17 +52,20 @@ ChessGame::ChessGame(bool graphics, bool greenTiles, bool assignmentStyle) : gam
 }
 
 void ChessGame::run() { // run
+    Trace::setThreadName("game"); // track of the game loop
     string command; 
-    while (getline(cin, command)) { 
+    while (input.readLine(command)) { 
         if (command == "quit" || command == "exit") { // if input is quit or exit
             break; // break
         }
         if (!readInstructions(command)) { // if read instructions
             cout << "Invalid command. Type 'help' for commands." << endl; // invalid command
         }
+        if (quitRequested) break; // quit typed during a game
     }
     
     displayFinalScore(); // display final score
+    if (Trace::stop()) cout << "Trace written to " << Trace::getFilename() << endl; // finish a recording left running
 }
 
 bool ChessGame::readInstructions(const string& instruction) { // read instructions
@@ -96,7 +108,121 @@ bool ChessGame::readInstructions(const string& instruction) { // read instructio
     } else if (command == "display" && tokens.size() == 2) { // if command is display and tokens size is 2
         switchDisplayMode(tokens[1]); // switch display mode
         return true; // return true
-    } 
+    } else if (command == "perft" && (tokens.size() == 2 || tokens.size() == 3)) { // if command is perft
+        int depth; // depth
+        try {
+            depth = stoi(tokens[1]); // depth
+        } catch (const exception&) { // if depth is not a number
+            return false; // return false
+        }
+        if (depth < 0) return false; // if depth is negative
+        bool showDivide = (tokens.size() == 3 && tokens[2] == "divide"); // per root move counts
+        Perft::run(*board, depth, showDivide, cout); // count from the current position
+        return true; // return true
+    } else if (command == "hash" && tokens.size() <= 2) { // if command is hash
+        if (tokens.size() == 2) { // if a size is given
+            int mb; // size in megabytes
+            try {
+                mb = stoi(tokens[1]); // size
+            } catch (const exception&) { // if size is not a number
+                return false; // return false
+            }
+            if (mb <= 0) return false; // if size is not positive
+            stopPondering(); // tables must be idle
+            engine.transpositionTable.resize(mb); // reallocate table
+        }
+        printHashStats(); // print size and counters
+        return true; // return true
+    } else if (command == "pawnhash" && tokens.size() <= 2) { // if command is pawnhash
+        if (tokens.size() == 2) { // if a size or clear is given
+            if (tokens[1] == "clear") { // if clearing
+                stopPondering(); // tables must be idle
+                engine.pawnTables.clear(); // empty tables
+            } else {
+                int kb; // size in kilobytes
+                try {
+                    kb = stoi(tokens[1]); // size
+                } catch (const exception&) { // if size is not a number
+                    return false; // return false
+                }
+                if (kb <= 0) return false; // if size is not positive
+                stopPondering(); // tables must be idle
+                engine.pawnTables.resize(kb); // reallocate tables
+            }
+        }
+        printPawnHashStats(); // print size and counters
+        return true; // return true
+    } else if (command == "threads" && tokens.size() <= 2) { // if command is threads
+        if (tokens.size() == 2) { // if a count is given
+            int count; // thread count
+            try {
+                count = stoi(tokens[1]); // count
+            } catch (const exception&) { // if count is not a number
+                return false; // return false
+            }
+            if (count < 1 || count > MAX_THREADS) return false; // if count is out of range
+            stopPondering(); // a ponder hit would otherwise finish the next move with the old count
+            engine.threads = count; // search threads
+        }
+        cout << "Threads: " << engine.threads << " (" << thread::hardware_concurrency() << " available)" << endl; // thread count
+        return true; // return true
+    } else if (command == "time" && tokens.size() <= 4) { // if command is time
+        if (tokens.size() >= 2) { // if a time control is given
+            TimeControl control; // time control
+            try {
+                if (tokens[1] == "move") { // fixed time per move
+                    if (tokens.size() != 3) return false; // if the time is missing
+                    control.moveTimeMs = stoll(tokens[2]); // time per move
+                    if (control.moveTimeMs <= 0) return false; // if time is not positive
+                } else { // clock with increment and moves to go
+                    control.remainingMs = stoll(tokens[1]); // base time
+                    if (tokens.size() >= 3) control.incrementMs = stoll(tokens[2]); // increment
+                    if (tokens.size() == 4) control.movesToGo = stoi(tokens[3]); // moves to go
+                    if (control.remainingMs <= 0 || control.incrementMs < 0 || control.movesToGo < 0) return false; // if a value is out of range
+                }
+            } catch (const exception&) { // if a value is not a number
+                return false; // return false
+            }
+            engine.timeControl = control; // a running clock keeps its time until the next game
+        }
+        printTimeControl(); // print time control
+        return true; // return true
+    } else if (command == "ponder" && tokens.size() <= 2) { // if command is ponder
+        if (tokens.size() == 2) { // if a setting is given
+            if (tokens[1] != "on" && tokens[1] != "off") return false; // only on and off are accepted
+            engine.ponder = (tokens[1] == "on"); // think on the opponent's time
+            if (!engine.ponder) stopPondering(); // drop any ponder search
+        }
+        cout << "Ponder: " << (engine.ponder ? "on" : "off") << endl; // ponder setting
+        return true; // return true
+    } else if (command == "ordering" && tokens.size() <= 2) { // if command is ordering
+        if (tokens.size() == 2) { // if an argument is given
+            if (tokens[1] != "clear") return false; // only clear is accepted
+            engine.orderingStats.clear(); // reset counters
+        }
+        printOrderingStats(); // print counters
+        return true; // return true
+    } else if (command == "arena" && tokens.size() == 1) { // if command is arena
+        printArenaStats(); // print counters
+        return true; // return true
+    } else if (command == "trace" && tokens.size() == 2) { // if command is trace
+        if (tokens[1] == "stop") { // if finishing a recording
+            if (!Trace::stop()) { // if nothing was recorded
+                cout << "Not tracing." << endl;
+                return true; // return true
+            }
+            cout << "Trace written to " << Trace::getFilename() << endl; // file to load into a trace viewer
+        } else if (Trace::start(tokens[1])) { // if the file could be opened
+            cout << "Tracing to " << tokens[1] << ", type 'trace stop' to write it." << endl; // recording
+        } else {
+            cout << "Cannot write " << tokens[1] << endl; // bad path
+        }
+        return true; // return true
+    } else if (command == "stats" && (tokens.size() == 1 || (tokens.size() == 2 && tokens[1] == "clear"))) { // if command is stats
+        if (tokens.size() == 2) Stats::clear(); // zero counters
+        Stats::print(cout); // print counters
+        return true; // return true
+    }
     else if (command == "save" && tokens.size() == 3) { // if command is save and tokens size is 3
         string formatString = tokens[1]; // format
         string filename = tokens[2]; // filename
@@ -147,15 +273,15 @@ bool ChessGame::readInstructions(const string& instruction) { // read instructio
 
 void ChessGame::newGame(PlayerType whiteType, PlayerType blackType) {
     if (whiteType == PlayerType::HUMAN) { // if white is human
-        white = make_unique<Human>(Color::WHITE); // white player
+        white = make_unique<Human>(Color::WHITE, input); // white player
     } else { // if white is not human
-        white = make_unique<Computer>(Color::WHITE, whiteType); // white player
+        white = make_unique<Computer>(Color::WHITE, whiteType, engine); // white player
     }
     
     if (blackType == PlayerType::HUMAN) { // if black is human
-        black = make_unique<Human>(Color::BLACK); // black player
+        black = make_unique<Human>(Color::BLACK, input); // black player
     } else { // if black is not human
-        black = make_unique<Computer>(Color::BLACK, blackType); // black player
+        black = make_unique<Computer>(Color::BLACK, blackType, engine); // black player
     }
     
     if (ifCustomSetup) { // if has custom setup
@@ -172,6 +298,7 @@ void ChessGame::newGame(PlayerType whiteType, PlayerType blackType) {
 
 void ChessGame::runGameLoop() { // run game loop
     while (gameActive) { // while game active
+        TRACE_SCOPE("turn", "ply", board->getMoveHistory().size()); // one move of the game
         Color currentPlayer = board->getCurrentPlayer(); // current player color
         Player* currentPlayerPtr; // current player
         if (currentPlayer == Color::WHITE) { // if current player color is white
@@ -180,7 +307,11 @@ void ChessGame::runGameLoop() { // run game loop
             currentPlayerPtr = black.get(); // current player
         } // current player
         
-        vector<Move> legalMoves = board->getAllLegalMoves(currentPlayer); // legal moves
+        vector<Move> legalMoves; // legal moves
+        {
+            TRACE_SCOPE("move generation");
+            legalMoves = board->getAllLegalMoves(currentPlayer); // legal moves
+        }
         
         if (legalMoves.empty()) { // if legal moves is empty
             if (board->isInCheck(currentPlayer)) { // if current player color is in check
@@ -206,7 +337,16 @@ void ChessGame::runGameLoop() { // run game loop
             break; // break
         }
         
-        Move chosenMove = currentPlayerPtr->makeMove(*board); // selected move
+        Computer* computer = dynamic_cast<Computer*>(currentPlayerPtr); // computer player, if any
+        Move chosenMove; // selected move
+        if (computer && computer->thinksInBackground()) { // if the computer searches on its own thread
+            TRACE_SCOPE("move selection");
+            chosenMove = thinkResponsively(*computer); // keep reading commands meanwhile
+            if (quitRequested) break; // quit typed while thinking
+        } else {
+            TRACE_SCOPE(computer ? "move selection" : "input"); // humans spend it typing
+            chosenMove = currentPlayerPtr->makeMove(*board); // selected move
+        }
         
         if (!chosenMove.init.isValid()) { // if selected move is not valid
             Color WinnerColor = oppositeColor(currentPlayer); 
@@ -220,6 +360,12 @@ void ChessGame::runGameLoop() { // run game loop
         
         if (board->move(chosenMove)) {
             notifyDisplays(); // notify displays
+            runCommandsAfterMove(); // commands typed while thinking
+            
+            Player* opponent = (currentPlayer == Color::WHITE) ? black.get() : white.get(); // player to move next
+            if (computer && engine.ponder && opponent->isHuman()) { // if the computer may think on the human's time
+                computer->startPondering(*board); // search the expected reply
+            }
             
             GameState currentState = board->getGameState(); // game state
             if (currentState == GameState::CHECKMATE_WHITE_WINS || 
@@ -254,9 +400,69 @@ void ChessGame::runGameLoop() { // run game loop
         }
     }
     
+    stopPondering(); // no more thinking on a finished game
+    while (!commandsAfterMove.empty()) { // game ended before they ran
+        input.defer(commandsAfterMove.front()); // run as normal commands
+        commandsAfterMove.pop_front();
+    }
     cout << "Type 'game human human' to start a new game." << endl; // type 'game human human' to start a new game
 }
 
+void ChessGame::runCommandsAfterMove() { // run the commands typed while the engine was thinking
+    while (!commandsAfterMove.empty()) {
+        string line = commandsAfterMove.front(); // command
+        commandsAfterMove.pop_front();
+        string command = tokenize(line)[0]; // command name
+        if (command == "game" || command == "move" || command == "setup" || command == "default" || command == "load") { // if it would change the game being played
+            cout << "'" << line << "' is not available during a game." << endl;
+        } else if (!readInstructions(line)) { // if the command is not valid
+            cout << "Invalid command. Type 'help' for commands." << endl; // invalid command
+        }
+    }
+}
+
+Move ChessGame::thinkResponsively(Computer& computer) { // let the computer think while still reading commands
+    computer.beginMove(*board); // start the search
+    string line; // command typed while thinking
+    while (!computer.moveReady(50)) {
+        if (!input.pollLine(line)) continue; // nothing typed
+        vector<string> tokens = tokenize(line); // tokens
+        if (tokens.empty()) continue; // blank line
+        
+        if (tokens[0] == "quit" || tokens[0] == "exit") { // if input is quit or exit
+            computer.abandonMove(); // drop the search
+            quitRequested = true; // leave the game and the program
+            return Move(); // no move
+        } else if (tokens[0] == "resign") { // if input is resign
+            computer.abandonMove(); // drop the search
+            return Move(); // the computer to move resigns
+        } else if (tokens[0] == "stop") { // if input is stop
+            computer.stopThinking(); // move now
+        } else if ((tokens[0] == "display" || tokens[0] == "theme") && tokens.size() == 2) { // if input changes the display
+            switchDisplayMode(tokens[1]); // switch display mode
+        } else if (tokens[0] == "score") { // if input is score
+            printScore(); // print score
+        } else { // anything else waits for the move
+            Player* opponent = (computer.getColor() == Color::WHITE) ? black.get() : white.get(); // player to move next
+            if (tokens[0] == "move" && opponent->isHuman()) {
+                input.defer(line); // the human's next move, typed ahead
+            } else {
+                commandsAfterMove.push_back(line); // run once the computer has moved
+            }
+            cout << "(engine is thinking, '" << line << "' will run after its move; type stop to move now)" << endl;
+        }
+    }
+    return computer.finishMove(); // collect the move
+}
+
+void ChessGame::stopPondering() { // end ponder searches of both players
+    for (Player* player : {white.get(), black.get()}) {
+        if (Computer* computer = dynamic_cast<Computer*>(player)) {
+            computer->stopPondering(); // drop ponder search
+        }
+    }
+}
+
 void ChessGame::resign() {
     if (!gameActive) {
         cout << "No active game." << endl; // no active game
@@ -286,7 +492,7 @@ void ChessGame::startSetup() {
 
 void ChessGame::leaveSetupMode() {
     if (!board->isValidSetup()) { // if board is not valid setup
-        cout << "Invalid setup. Must have exactly one king per side, no pawns on back ranks, and no kings in check." << endl; // invalid setup
+        cout << "Invalid setup. Must have exactly one king per side, no pawns on back ranks, no kings in check, and no more than 16 pieces and 8 pawns per side (extra pieces count as promoted pawns)." << endl; // invalid setup
         return; // return
     }
     
@@ -300,10 +506,10 @@ bool ChessGame::addPiece(char piece, const string& position) {
     Position pos = Position::fromAlgebraic(position); // position
     if (!pos.isValid()) return false; // if position is not valid
     
-    auto piecePtr = PieceFactory::initPieceFromChar(piece); // piece pointer
+    const Piece* piecePtr = PieceFactory::initPieceFromChar(piece); // shared piece
     if (!piecePtr) return false; // if piece pointer is not valid
     
-    board->setPiece(pos, std::move(piecePtr)); // set piece
+    board->setPiece(pos, piecePtr); // set piece
     return true; // return true
 }
 
@@ -370,6 +576,7 @@ bool ChessGame::doAlgoMove() {
 }
 
 void ChessGame::notifyDisplays() {
+    TRACE_SCOPE("render");
     cout << "\033[2J\033[H"; // clear screen
     
     if (textDisplay) { // if text display
@@ -431,6 +638,16 @@ void ChessGame::printHelp() {
     cout << "  resign\n"; // resign
     cout << "  setup\n"; // setup
     cout << "  default\n"; // default
+    cout << "  perft <depth> [divide]\n"; // perft <depth> [divide]
+    cout << "  hash [mb]\n"; // hash [mb]
+    cout << "  pawnhash [kb | clear]\n"; // pawnhash [kb | clear]
+    cout << "  threads [n]\n"; // threads [n]
+    cout << "  time [move <ms> | <base ms> [increment ms] [moves to go]]\n"; // time control
+    cout << "  ponder [on|off]\n"; // ponder [on|off]
+    cout << "  ordering [clear]\n"; // ordering [clear]
+    cout << "  arena\n"; // arena
+    cout << "  stats [clear]\n"; // stats [clear]
+    cout << "  trace <file> | trace stop\n"; // trace <file> | trace stop
     cout << "  help\n"; // help
     cout << "  quit\n"; // quit
     cout << "\nFile Operations:\n"; // file operations
@@ -452,6 +669,7 @@ void ChessGame::printHelp() {
     cout << "  computer1\n";
     cout << "  computer2\n";
     cout << "  computer3\n";
+    cout << "  computer4\n";
 }
 
 void ChessGame::printScore() { // print score
@@ -460,6 +678,103 @@ void ChessGame::printScore() { // print score
     cout << "Black: " << scores[Color::BLACK] << endl; // black
 }
 
+void ChessGame::printHashStats() { // print transposition table size and counters
+    cout << "Hash: " << engine.transpositionTable.getSizeMB() << " MB, " << engine.transpositionTable.getEntryCount() << " entries" << endl; // size
+    cout << "Hits: " << engine.transpositionTable.getHits() << endl; // hits
+    cout << "Misses: " << engine.transpositionTable.getMisses() << endl; // misses
+    cout << "Collisions: " << engine.transpositionTable.getCollisions() << endl; // collisions
+    cout << "Stores: " << engine.transpositionTable.getStores() << endl; // stores
+    cout << "Full: " << engine.transpositionTable.hashfull() << " permille" << endl; // hashfull
+}
+
+void ChessGame::printPawnHashStats() { // print pawn table size and counters
+    uint64_t hits = engine.pawnTables.getHits(); // hits
+    uint64_t probes = hits + engine.pawnTables.getMisses(); // probes
+    cout << "Pawn hash: " << engine.pawnTables.getSizeKB() << " KB per thread, " << engine.pawnTables.getTableCount() << " tables" << endl; // size
+    cout << "Hits: " << hits << endl; // hits
+    cout << "Misses: " << engine.pawnTables.getMisses() << endl; // misses
+    cout << "Hit rate: " << fixed << setprecision(1) << (probes ? 100.0 * hits / probes : 0.0) << "%" << endl; // hit rate
+    cout.unsetf(ios::floatfield); // restore default formatting
+    cout << setprecision(6);
+}
+
+// next line, waiting for it if needed
+bool ConsoleInput::readLine(string& line) {
+    if (!deferred.empty()) {
+        line = deferred.front(); // line read while the engine was thinking
+        deferred.pop_front();
+        return true;
+    }
+    while (!takeLine(line)) {
+        if (closed || !fill()) { // end of input
+            if (pending.empty()) return false;
+            line.swap(pending); // last line without a newline
+            return true;
+        }
+    }
+    return true;
+}
+
+// next new line if one is ready, never waits
+bool ConsoleInput::pollLine(string& line) {
+    while (!takeLine(line)) {
+        if (closed) return false; // nothing more will come
+        pollfd request = {STDIN_FILENO, POLLIN, 0}; // wait for input on stdin
+        if (poll(&request, 1, 0) <= 0) return false; // nothing typed yet
+        if (!fill()) return false; // end of input
+    }
+    return true;
+}
+
+// split the first complete line off pending
+bool ConsoleInput::takeLine(string& line) {
+    size_t end = pending.find('\n'); // end of the first line
+    if (end == string::npos) return false; // incomplete
+    line = pending.substr(0, end); // line
+    pending.erase(0, end + 1);
+    if (!line.empty() && line.back() == '\r') line.pop_back(); // windows line ending
+    return true;
+}
+
+// read whatever is available into pending, false at end of input
+bool ConsoleInput::fill() {
+    char buffer[4096]; // chunk
+    ssize_t count; // bytes read
+    do {
+        count = read(STDIN_FILENO, buffer, sizeof(buffer)); // blocks only when nothing is available
+    } while (count < 0 && errno == EINTR);
+    if (count <= 0) {
+        closed = true; // end of input or error
+        return false;
+    }
+    pending.append(buffer, count);
+    return true;
+}
+
+// hand a line out again from readLine
+void ConsoleInput::defer(const string& line) {
+    deferred.push_back(line);
+}
+
+void ChessGame::printTimeControl() { // print the computer time control
+    const TimeControl& control = engine.timeControl; // time control
+    if (control.moveTimeMs > 0) { // fixed time per move
+        cout << "Time: " << control.moveTimeMs << " ms per move" << endl; // time per move
+    } else { // clock
+        cout << "Time: " << control.remainingMs << " ms + " << control.incrementMs << " ms per move"; // base and increment
+        if (control.movesToGo > 0) cout << ", " << control.movesToGo << " moves per control"; // moves to go
+        cout << endl;
+    }
+}
+
+void ChessGame::printOrderingStats() { // print move ordering cutoff counters
+    engine.orderingStats.print(cout); // table per stage
+}
+
+void ChessGame::printArenaStats() { // print search memory counters
+    engine.arenaStats.print(cout); // counters over every computer move
+}
+
 void ChessGame::displayFinalScore() { // display final score
     cout << "Final Score:" << endl; // final score
     cout << "White: " << scores[Color::WHITE] << endl; // white
@@ -512,9 +827,9 @@ bool ChessGame::loadGameFromFEN(const string& filename) {
 
 unique_ptr<Player> ChessGame::createPlayer(PlayerType type, Color color) { // create player
     if (type == PlayerType::HUMAN) { // if type is human
-        return make_unique<Human>(color); // human player
+        return make_unique<Human>(color, input); // human player
     } else {
-        return make_unique<Computer>(color, type); // computer player
+        return make_unique<Computer>(color, type, engine); // computer player
     }
 }
 
@@ -523,6 +838,7 @@ PlayerType ChessGame::parsePlayerType(const string& playerInput) { // parse play
     if (playerInput == "computer1") return PlayerType::COMPUTER_LEVEL1; // computer1
     if (playerInput == "computer2") return PlayerType::COMPUTER_LEVEL2; // computer2
     if (playerInput == "computer3") return PlayerType::COMPUTER_LEVEL3; // computer3
+    if (playerInput == "computer4") return PlayerType::COMPUTER_LEVEL4; // computer4
     return PlayerType::HUMAN; // human
 }
 
@@ -549,13 +865,13 @@ bool ChessGame::isValidPosition(const string& position) { // is valid position
            position[1] >= '1' && position[1] <= '8'; // return true if position is valid
 }
 
-Move Human::selectMove(const Board& board, const vector<Move>& legalMoves) { // select move
+Move Human::selectMove(Board& board, const vector<Move>& legalMoves) { // select move
     string inputString; // input
     
     while (true) { // while true
         cout << "Enter Input or press help: "; // enter input or press help
         
-        if (!getline(cin, inputString)) { // if input is not valid
+        if (!input.readLine(inputString)) { // if input is not valid
             return Move(); // return move
         }
         
@@ -589,7 +905,7 @@ Move Human::selectMove(const Board& board, const vector<Move>& legalMoves) { //
                                 string promotionInput; // promotion input
                                 while (true) {
                                     cout << "Pawn promotion! Choose piece (Q=Queen, R=Rook, B=Bishop, N=Knight): "; // pawn promotion! Choose piece (Q=Queen, R=Rook, B=Bishop, N=Knight):
-                                    if (!getline(cin, promotionInput)) { // if promotion input is not valid
+                                    if (!input.readLine(promotionInput)) { // if promotion input is not valid
                                         return Move(); // return move
                                     }
                                     
@@ -635,14 +951,16 @@ Move Human::parseInput(const string& input, const vector<Move>& legalMoves) { //
     return Move(); // return move
 }
 
-    Move Computer::selectMove(const Board& board, const vector<Move>& legalMoves) { // select move
+    Move Computer::selectMove(Board& board, const vector<Move>& legalMoves) { // select move
     if (type == PlayerType::COMPUTER_LEVEL1) { // if type is computer level 1
         return Rmove(legalMoves); // return select random move
     } else if (type == PlayerType::COMPUTER_LEVEL2) { // if type is computer level 2
         return R2Move(board, legalMoves); // return select level 2 move
     } else if (type == PlayerType::COMPUTER_LEVEL3) { // if type is computer level 3
         return R3Move(board, legalMoves); // return select level 3 move
-    } else { // if type is not computer level 1, 2, or 3
+    } else if (type == PlayerType::COMPUTER_LEVEL4) { // if type is computer level 4
+        return R4Move(board, legalMoves); // return select level 4 move
+    } else { // if type is not computer level 1, 2, 3, or 4
         return Rmove(legalMoves); // return select random move
     }
 }
@@ -650,8 +968,6 @@ Move Human::parseInput(const string& input, const vector<Move>& legalMoves) { //
 Move Computer::Rmove(const vector<Move>& legalMoves) { // select random move
     if (legalMoves.empty()) return Move(); // if legal moves is empty
     
-    this_thread::sleep_for(chrono::milliseconds(WINDOW_SIZE)); // sleep for WINDOW_SIZE milliseconds
-    
     random_device device; // random device
     mt19937 gen(device()); // mt19937
     uniform_int_distribution<> dis(0, legalMoves.size() - 1); // uniform int distribution
@@ -664,11 +980,9 @@ Move Computer::Rmove(const vector<Move>& legalMoves) { // select random move
     return chosenMove; // return selected move
 }
 
-Move Computer::R2Move(const Board& board, const vector<Move>& legalMoves) { // select level 2 move
+Move Computer::R2Move(Board& board, const vector<Move>& legalMoves) { // select level 2 move
     if (legalMoves.empty()) return Move(); // if legal moves is empty
     
-    this_thread::sleep_for(chrono::milliseconds(750)); // sleep for 750 milliseconds
-    
     vector<Move> captureMoves; // capture moves
     vector<Move> checkMoves; // check moves
     vector<Move> regularMoves; // regular moves
@@ -712,18 +1026,16 @@ Move Computer::R2Move(const Board& board, const vector<Move>& legalMoves) { // s
     return chosenMove; // return selected move
 }
 
-Move Computer::R3Move(const Board& board, const vector<Move>& legalMoves) { // select level 3 move
+Move Computer::R3Move(Board& board, const vector<Move>& legalMoves) { // select level 3 move
     if (legalMoves.empty()) return Move(); // if legal moves is empty
     
-    this_thread::sleep_for(chrono::milliseconds(1000)); // sleep for 1000 milliseconds
-    
     vector<Move> safeCaptureMoves; // safe capture moves
     vector<Move> safeCheckMoves; // safe check moves
     vector<Move> safeMoveMoves; // safe move moves
     vector<Move> riskyMoveMoves; // risky move moves
     
     for (const Move& move : legalMoves) { // for each move in legal moves
-        bool isSafe = !noCapture(board, move); // is safe
+        bool isSafe = SEE::isSafe(board, move); // exchange on the target square does not lose material
         
         if (move.isCap && isSafe) { // if move is capture and is safe
             safeCaptureMoves.push_back(move); // add move to safe capture moves
@@ -770,7 +1082,110 @@ Move Computer::R3Move(const Board& board, const vector<Move>& legalMoves) { // s
     return chosenMove; // return selected move
 }
 
-int Computer::isSlay(const Board& board, const Move& move) { // evaluate move
+Move Computer::R4Move(Board& board, const vector<Move>& legalMoves) { // select level 4 move
+    if (legalMoves.empty()) return Move(); // if legal moves is empty
+    
+    beginMove(board); // search on the background thread
+    return finishMove(); // wait for it
+}
+
+SearchLimits Computer::moveLimits() const { // budget for the next move from the time control and clock
+    SearchLimits limits; // search budget
+    limits.threads = engine.threads; // lazy smp threads
+    limits.time = engine.timeControl; // time control
+    if (limits.time.moveTimeMs <= 0 && limits.time.remainingMs > 0) { // if playing on a clock
+        if (clockMs >= 0) limits.time.remainingMs = max<int64_t>(1, clockMs); // time left, a full clock before the first move
+        if (limits.time.movesToGo > 0) { // if the clock refills every few moves
+            limits.time.movesToGo -= movesPlayed % limits.time.movesToGo; // moves until the refill
+        }
+    }
+    return limits; // return limits
+}
+
+void Computer::beginMove(const Board& board) { // start thinking, or turn a matching ponder search into the real one
+    moveStart = chrono::steady_clock::now(); // turn starts
+    if (pondering) { // if a ponder search is running
+        pondering = false; // it becomes the move search or is dropped
+        if (thinking.getPosition().getZobristKey() == board.getZobristKey()) { // if the expected reply was played
+            showProgress = true; // report from now on
+            thinking.ponderHit(); // keep the search; its deadlines date from the ponder start, so the time already pondered counts against this move
+            cout << "(ponder hit)" << endl;
+            return;
+        }
+        thinking.stop(); // wrong guess
+        thinking.wait(); // drop it
+    }
+    showProgress = true; // report iterations
+    thinking.start(board, engine.transpositionTable, engine.pawnTables, heuristics, moveLimits(),
+                   [this](const SearchResult& result) { printProgress(result); }); // search
+}
+
+bool Computer::moveReady(int timeoutMs) { // wait up to timeoutMs for the search, true when it has finished
+    return thinking.waitFor(timeoutMs);
+}
+
+Move Computer::finishMove() { // collect the result, charge the clock and announce the move
+    SearchResult result = thinking.wait(); // result
+    showProgress = false; // quiet until the next move
+    if (const OrderingStats* stats = thinking.getOrderingStats()) {
+        engine.orderingStats.add(*stats); // keep ordering counters
+    }
+    engine.arenaStats.add(thinking.getArenaStats()); // keep memory counters
+    int64_t spentMs = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - moveStart).count(); // time used
+    
+    if (clockMs < 0) clockMs = engine.timeControl.remainingMs; // first move starts with a full clock
+    movesPlayed++; // moves made
+    if (engine.timeControl.moveTimeMs <= 0 && engine.timeControl.remainingMs > 0) { // if playing on a clock
+        clockMs += engine.timeControl.incrementMs - spentMs; // charge the move
+        if (engine.timeControl.movesToGo > 0 && movesPlayed % engine.timeControl.movesToGo == 0) { // if a time control is reached
+            clockMs += engine.timeControl.remainingMs; // refill
+        }
+    }
+    lastPv = result.pv; // expected continuation
+    
+    cout << "\n" << colorToString(color) << " (Computer Level 4) plays: " 
+              << result.bestMove.init.toAlgebraic() << " " << result.bestMove.finalpos.toAlgebraic() 
+              << " (depth " << result.depth << ", score " << result.score << ", nodes " << result.nodes << ", threads " << result.threads << ", " << spentMs << " ms)" << endl; // color to string (color) (Computer Level 4) plays: selected move and search summary
+    return result.bestMove; // return selected move
+}
+
+void Computer::abandonMove() { // stop thinking and drop the result
+    thinking.stop(); // stop
+    thinking.wait(); // join
+    showProgress = false; // quiet
+    pondering = false; // nothing running
+}
+
+void Computer::startPondering(const Board& board) { // search the expected reply during the opponent's turn
+    if (lastPv.size() < 2) return; // no expected reply
+    Board next(board); // position after the expected reply
+    PackedMove expected = lastPv[1]; // expected reply
+    if (!next.getLegalMoveList(next.getCurrentPlayer()).contains(expected)) return; // stale line
+    if (!next.move(next.toMove(expected))) return; // could not play it
+    if (next.getLegalMoveList(next.getCurrentPlayer()).empty()) return; // game would be over
+    
+    SearchLimits limits = moveLimits(); // budget once the reply is played
+    limits.ponder = true; // no deadlines until then
+    showProgress = false; // silent while the opponent thinks
+    thinking.start(next, engine.transpositionTable, engine.pawnTables, heuristics, limits,
+                   [this](const SearchResult& result) { printProgress(result); }); // ponder
+    pondering = true;
+}
+
+void Computer::stopPondering() { // drop a running ponder search
+    if (pondering) abandonMove(); // stop and join
+}
+
+void Computer::printProgress(const SearchResult& result) { // print an iteration report
+    if (!showProgress) return; // pondering
+    cout << "  depth " << result.depth << " score " << result.score << " nodes " << result.nodes << " pv"; // summary
+    for (PackedMove move : result.pv) {
+        cout << " " << move.toUCI(); // principal variation
+    }
+    cout << endl;
+}
+
+int Computer::isSlay(Board& board, const Move& move) { // evaluate move
     int currentScore = 0; // current score
     
     if (move.isCap) { // if move is capture
@@ -811,20 +1226,20 @@ int Computer::isSlay(const Board& board, const Move& move) { // evaluate move
     return currentScore; // return score
 }
 
-bool Computer::isCheck(const Board& board, const Move& move) { // gives check
-    auto copyBoard = board.createCopy(); // board copy
-    if (copyBoard->applyMoveToBoard(move)) { // if move is applied to board
-        Color opponent = oppositeColor(color); // opponent color
-        return copyBoard->isInCheck(opponent); // return true if opponent is in check
-    }
-    return false; // return false
+bool Computer::isCheck(Board& board, const Move& move) { // gives check
+    if (!board.getPiece(move.init)) return false; // if piece is empty
+    MoveUndo undo; // undo record
+    board.makeMove(move, undo); // make move
+    bool retval = board.isInCheck(oppositeColor(color)); // true if opponent is in check
+    board.unmakeMove(move, undo); // unmake move
+    return retval; // return result
 }
 
-bool Computer::noCapture(const Board& board, const Move& move) { // avoids capture
-    auto copyBoard = board.createCopy(); // board copy
-    if (copyBoard->applyMoveToBoard(move)) { // if move is applied to board
-        Color opponent = oppositeColor(color); // opponent color
-        return copyBoard->isSquareAttacked(move.finalpos, opponent); // return true if opponent is square attacked
-    }
-    return false;
+bool Computer::noCapture(Board& board, const Move& move) { // avoids capture
+    if (!board.getPiece(move.init)) return false; // if piece is empty
+    MoveUndo undo; // undo record
+    board.makeMove(move, undo); // make move
+    bool retval = board.isSquareAttacked(move.finalpos, oppositeColor(color)); // true if opponent attacks the square
+    board.unmakeMove(move, undo); // unmake move
+    return retval; // return result
 } 
@@ -4,7 +4,13 @@
 #include "Board.h"
 #include "TextDisplay.h"
 #include "GraphicalDisplay.h"
+#include "TranspositionTable.h"
+#include "Search.h"
+#include "AsyncSearch.h"
 #include "types.h"
+#include <atomic>
+#include <chrono>
+#include <deque>
 #include <memory>
 #include <string>
 #include <map>
@@ -16,7 +22,25 @@ enum class PlayerType { // player type
     HUMAN,
     COMPUTER_LEVEL1,
     COMPUTER_LEVEL2,
-    COMPUTER_LEVEL3
+    COMPUTER_LEVEL3,
+    COMPUTER_LEVEL4
+};
+
+// standard input read straight from its descriptor, so a line that has
+// arrived is never hidden in a stream buffer when polling for it
+class ConsoleInput {
+    deque<string> deferred; // lines read early, handed out before new input
+    string pending; // bytes read but not yet split into lines
+    bool closed; // end of input reached
+    
+    bool takeLine(string& line); // split the first complete line off pending
+    bool fill(); // read whatever is available into pending, false at end of input
+    
+public:
+    ConsoleInput() : closed(false) {} // constructor
+    bool readLine(string& line); // next line, waiting for it if needed
+    bool pollLine(string& line); // next new line if one is ready, never waits
+    void defer(const string& line); // hand a line out again from readLine
 };
 
 class Player { // player
@@ -29,7 +53,7 @@ public:
     Player(Color c, PlayerType t) : color(c), type(t) {} // constructor
     virtual ~Player() = default; // destructor
     
-    Move makeMove(const Board& board) { // make move
+    Move makeMove(Board& board) { // make move
         vector<Move> legalMoves = board.getAllLegalMoves(color);
         if (legalMoves.empty()) { // if there are no legal moves
             return Move(); // return empty move
@@ -42,33 +66,66 @@ public:
     PlayerType getType() const { return type; } // get type
     virtual bool isHuman() const { return type == PlayerType::HUMAN; } // is human
     
-    virtual Move selectMove(const Board& board, const vector<Move>& legalMoves) = 0;
+    virtual Move selectMove(Board& board, const vector<Move>& legalMoves) = 0; // lookahead may make and unmake moves on board
 };
 
 class Human : public Player { // human player
+    ConsoleInput& input; // where moves are typed
     Move parseInput(const string& input, const vector<Move>& legalMoves); // parse input
 
 protected:
-    Move selectMove(const Board& board, const vector<Move>& legalMoves) override;
+    Move selectMove(Board& board, const vector<Move>& legalMoves) override;
 
 public:
-    Human(Color c) : Player(c, PlayerType::HUMAN) {} // constructor
+    Human(Color c, ConsoleInput& in) : Player(c, PlayerType::HUMAN), input(in) {} // constructor
+};
+
+struct EngineContext { // search resources shared by every computer player in the game
+    TranspositionTable transpositionTable; // search cache
+    PawnTables pawnTables; // pawn structure caches, one per search thread
+    OrderingStats orderingStats; // move ordering counters of every search this session
+    ArenaStats arenaStats; // search memory of every computer move this session
+    int threads = 1; // search threads per move
+    bool ponder = false; // think on the opponent's time
+    TimeControl timeControl{1000}; // one second per move unless a clock is set
 };
 
 class Computer : public Player { // computer player
+    EngineContext& engine; // shared search resources
+    MoveHistory heuristics; // killers, history and countermoves kept between moves
+    int64_t clockMs; // time left on this player's clock, -1 before the first move
+    int movesPlayed; // moves made by this player this game
+    AsyncSearch thinking; // background search for the move or the ponder
+    bool pondering; // thinking is a ponder search on the expected reply
+    atomic<bool> showProgress; // print iteration reports, off while pondering
+    chrono::steady_clock::time_point moveStart; // when this player's turn began
+    vector<PackedMove> lastPv; // principal variation of the last move, its second move is the expected reply
     Move Rmove(const vector<Move>& legalMoves); // select random move
-    Move R2Move(const Board& board, const vector<Move>& legalMoves); // select level 2 move
-    Move R3Move(const Board& board, const vector<Move>& legalMoves); // select level 3 move
-    int isSlay(const Board& board, const Move& move); // evaluate move
-    bool isCheck(const Board& board, const Move& move); // gives check
-    bool noCapture(const Board& board, const Move& move); // avoids capture
+    Move R2Move(Board& board, const vector<Move>& legalMoves); // select level 2 move
+    Move R3Move(Board& board, const vector<Move>& legalMoves); // select level 3 move
+    Move R4Move(Board& board, const vector<Move>& legalMoves); // select level 4 move
+    SearchLimits moveLimits() const; // budget for the next move from the time control and clock
+    void printProgress(const SearchResult& result); // print an iteration report
+    int isSlay(Board& board, const Move& move); // evaluate move
+    bool isCheck(Board& board, const Move& move); // gives check
+    bool noCapture(Board& board, const Move& move); // avoids capture
 
 protected:
-    Move selectMove(const Board& board, const vector<Move>& legalMoves) override; // select move
+    Move selectMove(Board& board, const vector<Move>& legalMoves) override; // select move
 
 public:
-    Computer(Color c, PlayerType level) : Player(c, level) {} // constructor  
+    Computer(Color c, PlayerType level, EngineContext& context)
+        : Player(c, level), engine(context), clockMs(-1), movesPlayed(0), pondering(false), showProgress(false) {} // constructor
     bool isHuman() const override { return false; }
+    
+    bool thinksInBackground() const { return type == PlayerType::COMPUTER_LEVEL4; } // searches on its own thread
+    void beginMove(const Board& board); // start thinking, or turn a matching ponder search into the real one
+    bool moveReady(int timeoutMs); // wait up to timeoutMs for the search, true when it has finished
+    void stopThinking() { thinking.stop(); } // move now with the best move so far
+    Move finishMove(); // collect the result, charge the clock and announce the move
+    void abandonMove(); // stop thinking and drop the result
+    void startPondering(const Board& board); // search the expected reply during the opponent's turn
+    void stopPondering(); // drop a running ponder search
 };
 
 class ChessGame {
@@ -77,6 +134,9 @@ class ChessGame {
     unique_ptr<Player> black; // black player
     unique_ptr<TextDisplay> textDisplay; // text display
     unique_ptr<GraphicalDisplay> graphicalDisplay; // graphical display
+    EngineContext engine; // search resources shared by computer players
+    ConsoleInput input; // commands and moves
+    bool quitRequested; // quit typed while the engine was thinking
     bool gameActive; // game active
     bool Setup; // in setup mode
     bool ifCustomSetup; // has custom setup
@@ -84,6 +144,7 @@ class ChessGame {
     bool ifGreenTiles; // green tiles enabled
     bool ifAssignmentStyle; // assignment style enabled
     map<Color, double> scores; // scores
+    deque<string> commandsAfterMove; // commands typed while the engine was thinking
     
     void initializeGame(); // initialize game
     void gameLoop(); // game loop
@@ -98,6 +159,9 @@ class ChessGame {
     vector<string> tokenize(const string& input); // tokenize
     bool isValidPosition(const string& position); // is valid position
     void displayFinalScore(); // display final score
+    Move thinkResponsively(Computer& computer); // let the computer think while still reading commands
+    void runCommandsAfterMove(); // run the commands typed while the engine was thinking
+    void stopPondering(); // end ponder searches of both players
     
 public:
     ChessGame(bool graphics = true, bool greenTiles = false, bool assignmentStyle = false); // constructor
@@ -128,6 +192,11 @@ public:
     void switchDisplayMode(const string& mode); // switch display mode
     void printHelp(); // print help
     void printScore(); // print score
+    void printHashStats(); // print transposition table size and counters
+    void printPawnHashStats(); // print pawn table size and counters
+    void printOrderingStats(); // print move ordering cutoff counters
+    void printArenaStats(); // print search memory counters
+    void printTimeControl(); // print the computer time control
 };
 
 #endif 
@@ -0,0 +1,129 @@
+#include "Evaluation.h"
+#include "Attacks.h"
+#include "Board.h"
+#include "PawnTable.h"
+#include <algorithm>
+
+using namespace std;
+
+// squares on the ranks ahead of sq, seen from color's side
+static Bitboard forwardRanks(Color color, int sq) {
+    int rank = sq / 8; // rank
+    if (color == Color::WHITE) return rank < 7 ? ~Bitboard(0) << (8 * (rank + 1)) : 0;
+    return rank > 0 ? ~Bitboard(0) >> (8 * (8 - rank)) : 0;
+}
+
+// squares on the files either side of file
+static Bitboard adjacentFiles(int file) {
+    return (file > 0 ? FILE_A_BB << (file - 1) : 0) | (file < 7 ? FILE_A_BB << (file + 1) : 0);
+}
+
+// score from the side to move's point of view, pawns evaluated from scratch
+int Evaluation::evaluate(const Board& board) {
+    PawnEntry pawns; // entry used once
+    evaluatePawns(board, pawns); // structure score and passed pawns
+    return score(board, pawns); // return score
+}
+
+// score from the side to move's point of view, pawns cached
+int Evaluation::evaluate(const Board& board, PawnTable& pawnTable) {
+    return score(board, pawnTable.probe(board)); // return score
+}
+
+// blend the board sums with a pawn entry
+int Evaluation::score(const Board& board, PawnEntry& pawns) {
+    int mg = board.getMidgameScore() + pawns.midgame; // middlegame sum
+    int eg = board.getEndgameScore() + pawns.endgame; // endgame sum
+
+    for (Color color : {Color::WHITE, Color::BLACK}) {
+        int c = colorIndex(color); // color index
+        int sign = (color == Color::WHITE) ? 1 : -1; // white positive
+
+        Bitboard king = board.getPieces(color, PieceType::KING); // king
+        int kingSq = king ? lsb(king) : -1; // king square
+        if (pawns.kingSquare[c] != kingSq) { // king moved since the shield was cached
+            pawns.kingSquare[c] = kingSq;
+            pawns.shield[c] = kingShield(board, color);
+        }
+        mg += sign * pawns.shield[c]; // shield matters while pieces remain
+
+        Bitboard passed = pawns.passed[c]; // passed pawns
+        while (passed) {
+            int sq = popLsb(passed); // passed pawn square
+            Bitboard path = forwardRanks(color, sq) & (FILE_A_BB << (sq % 8)); // squares to promotion
+            if (!(path & board.getOccupancy())) {
+                int rank = (color == Color::WHITE) ? sq / 8 : 7 - sq / 8; // rank from its own side
+                eg += sign * FREE_PASSER_EG[rank]; // nothing in the way
+            }
+        }
+    }
+
+    int phase = min(board.getGamePhase(), PHASE_MAX); // early promotions can push it past the start
+    int score = (mg * phase + eg * (PHASE_MAX - phase)) / PHASE_MAX; // blend by phase
+    return (board.getCurrentPlayer() == Color::WHITE) ? score : -score; // return score
+}
+
+// fill the structure score and passed pawns of an entry
+void Evaluation::evaluatePawns(const Board& board, PawnEntry& entry) {
+    entry.midgame = 0;
+    entry.endgame = 0;
+    for (Color color : {Color::WHITE, Color::BLACK}) {
+        Color enemy = (color == Color::WHITE) ? Color::BLACK : Color::WHITE; // opponent
+        Bitboard own = board.getPieces(color, PieceType::PAWN); // own pawns
+        Bitboard theirs = board.getPieces(enemy, PieceType::PAWN); // enemy pawns
+        int mg = 0, eg = 0; // this color's terms
+        entry.passed[colorIndex(color)] = 0;
+
+        Bitboard pawns = own; // pawns left to score
+        while (pawns) {
+            int sq = popLsb(pawns); // pawn square
+            int file = sq % 8; // file
+            int rank = (color == Color::WHITE) ? sq / 8 : 7 - sq / 8; // rank from its own side
+            Bitboard ahead = forwardRanks(color, sq); // ranks in front
+            Bitboard fileMask = FILE_A_BB << file; // own file
+            Bitboard neighbours = adjacentFiles(file); // neighbouring files
+
+            bool doubled = own & fileMask & ahead; // rear pawn of a doubled pair
+            bool isolated = !(own & neighbours);
+            bool passed = !doubled && !(theirs & (fileMask | neighbours) & ahead);
+            int stop = (color == Color::WHITE) ? sq + 8 : sq - 8; // square in front
+            bool backward = !isolated && !passed && !(own & neighbours & ~ahead) // no neighbour level or behind to support it
+                            && (Attacks::pawn(color, stop) & theirs); // and an enemy pawn guards its advance
+
+            if (doubled) { mg += DOUBLED_MG; eg += DOUBLED_EG; }
+            if (isolated) { mg += ISOLATED_MG; eg += ISOLATED_EG; }
+            if (backward) { mg += BACKWARD_MG; eg += BACKWARD_EG; }
+            if (passed) {
+                mg += PASSED_MG[rank];
+                eg += PASSED_EG[rank];
+                entry.passed[colorIndex(color)] |= squareBit(sq); // remember for the uncached terms
+            }
+        }
+
+        int sign = (color == Color::WHITE) ? 1 : -1; // white positive
+        entry.midgame += sign * mg;
+        entry.endgame += sign * eg;
+    }
+}
+
+// pawn shield score of color's king
+int Evaluation::kingShield(const Board& board, Color color) {
+    Bitboard king = board.getPieces(color, PieceType::KING); // king
+    if (!king) return 0; // no king to shelter
+    int kingSq = lsb(king); // king square
+    int center = clamp(kingSq % 8, 1, 6); // keep three files on the board
+    Bitboard own = board.getPieces(color, PieceType::PAWN) & forwardRanks(color, kingSq); // own pawns in front of the king
+
+    int shield = 0; // score
+    for (int file = center - 1; file <= center + 1; ++file) {
+        Bitboard pawns = own & (FILE_A_BB << file); // shield pawns on this file
+        if (!pawns) {
+            shield += SHIELD_MG[0]; // open towards the king
+            continue;
+        }
+        int nearest = (color == Color::WHITE) ? lsb(pawns) : 63 - countl_zero(pawns); // closest to the king
+        int distance = abs(nearest / 8 - kingSq / 8); // ranks away
+        shield += SHIELD_MG[min(distance, 3)];
+    }
+    return shield;
+}
@@ -1,5 +1,6 @@
 #include "GraphicalDisplay.h"
 #include "window.h"
+#include "Stats.h"
 #include <iostream>
 #include <map>
 
@@ -46,6 +47,7 @@ void GraphicalDisplay::notifyDraw(const string& errmsg) { // notify draw
 }
 
 void GraphicalDisplay::renderBoard(const Board& board) { // render board
+    STATS_SCOPE(StatId::GRAPHICAL_DISPLAY);
     window->clear();
 
     window->fillRectangle(0, 0, boardSize + 80, boardSize + 80, Xwindow::BoardBorder); // fill rectangle
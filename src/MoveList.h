@@ -0,0 +1,119 @@
+#ifndef MOVELIST_H
+#define MOVELIST_H
+
+#include "types.h"
+#include "Bitboard.h"
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+
+using namespace std;
+
+// move flags, stored in the top four bits of a packed move
+const uint16_t MOVE_QUIET = 0;
+const uint16_t MOVE_DOUBLE_PUSH = 1;
+const uint16_t MOVE_KING_CASTLE = 2;
+const uint16_t MOVE_QUEEN_CASTLE = 3;
+const uint16_t MOVE_CAPTURE = 4; // set on every capture, including promotion captures
+const uint16_t MOVE_EN_PASSANT = 5;
+const uint16_t MOVE_PROMOTION = 8; // low two bits pick knight, bishop, rook or queen
+
+const int MAX_MOVES = 256; // more than any position with possible material has, see Board::hasPossibleMaterial
+
+inline uint16_t promotionFlag(PieceType type) { // promotion flag for a piece type
+    if (type == PieceType::KNIGHT) return MOVE_PROMOTION; // knight
+    if (type == PieceType::BISHOP) return MOVE_PROMOTION | 1; // bishop
+    if (type == PieceType::ROOK) return MOVE_PROMOTION | 2; // rook
+    return MOVE_PROMOTION | 3; // queen
+}
+
+class PackedMove { // from in bits 0-5, to in bits 6-11, flags in bits 12-15
+    uint16_t data; // packed bits
+
+public:
+    PackedMove() : data(0) {} // null move
+    PackedMove(int from, int to, uint16_t flags) : data(static_cast<uint16_t>(from | to << 6 | flags << 12)) {} // constructor
+    
+    explicit PackedMove(const Move& move) : data(0) { // pack a move built by the board or a piece
+        uint16_t flags = move.isCap ? MOVE_CAPTURE : MOVE_QUIET; // capture flag
+        if (move.isCast) { // if castling
+            flags = (move.finalpos.c > move.init.c) ? MOVE_KING_CASTLE : MOVE_QUEEN_CASTLE;
+        } else if (move.isEnp) { // if en passant
+            flags = MOVE_EN_PASSANT;
+        } else if (move.isProm) { // if promotion
+            flags |= promotionFlag(move.pProm);
+        } else if (move.pType == PieceType::PAWN && abs(move.finalpos.r - move.init.r) == 2) { // if double push
+            flags = MOVE_DOUBLE_PUSH;
+        }
+        *this = PackedMove(squareIndex(move.init), squareIndex(move.finalpos), flags);
+    }
+    
+    static PackedMove fromRaw(uint16_t raw) { // rebuild from packed bits
+        PackedMove move;
+        move.data = raw;
+        return move;
+    }
+    
+    int from() const { return data & 63; } // from square
+    int to() const { return (data >> 6) & 63; } // to square
+    uint16_t flags() const { return data >> 12; } // flags
+    uint16_t raw() const { return data; } // packed bits
+    
+    bool isNull() const { return data == 0; } // is null move
+    bool isCapture() const { return flags() & MOVE_CAPTURE; } // is capture
+    bool isPromotion() const { return flags() & MOVE_PROMOTION; } // is promotion
+    bool isEnPassant() const { return flags() == MOVE_EN_PASSANT; } // is en passant
+    bool isDoublePush() const { return flags() == MOVE_DOUBLE_PUSH; } // is double pawn push
+    bool isCastle() const { return flags() == MOVE_KING_CASTLE || flags() == MOVE_QUEEN_CASTLE; } // is castling
+    
+    PieceType promotion() const { // promotion piece
+        const PieceType types[4] = {PieceType::KNIGHT, PieceType::BISHOP, PieceType::ROOK, PieceType::QUEEN};
+        return types[flags() & 3];
+    }
+    
+    Move toMove(PieceType piece) const { // unpack, given the type of the moving piece
+        Move move(squareToPosition(from()), squareToPosition(to()), piece); // move
+        move.isCap = isCapture(); // capture
+        move.isEnp = isEnPassant(); // en passant
+        move.isCast = isCastle(); // castling
+        move.isProm = isPromotion(); // promotion
+        if (move.isProm) move.pProm = promotion(); // promotion piece
+        return move;
+    }
+    
+    string toUCI() const { return toMove(PieceType::PAWN).toUCI(); } // long algebraic notation
+    
+    bool operator==(const PackedMove& other) const { return data == other.data; }
+    bool operator!=(const PackedMove& other) const { return data != other.data; }
+};
+
+class MoveList { // fixed-capacity move list that lives on the stack
+    array<PackedMove, MAX_MOVES> moves; // moves
+    int count; // number of moves
+
+public:
+    MoveList() : count(0) {} // constructor
+    
+    void add(PackedMove move) { moves[count++] = move; } // append move
+    void add(int from, int to, uint16_t flags) { moves[count++] = PackedMove(from, to, flags); } // append move
+    void resize(int size) { count = size; } // drop moves past size
+    void clear() { count = 0; } // remove every move
+    
+    int size() const { return count; } // number of moves
+    bool empty() const { return count == 0; } // has no moves
+    bool contains(PackedMove move) const { // move is in the list
+        for (int i = 0; i < count; ++i) {
+            if (moves[i] == move) return true;
+        }
+        return false;
+    }
+    
+    PackedMove& operator[](int i) { return moves[i]; }
+    const PackedMove& operator[](int i) const { return moves[i]; }
+    PackedMove* begin() { return moves.data(); }
+    PackedMove* end() { return moves.data() + count; }
+    const PackedMove* begin() const { return moves.data(); }
+    const PackedMove* end() const { return moves.data() + count; }
+};
+
+#endif
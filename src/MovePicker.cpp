@@ -0,0 +1,242 @@
+#include "MovePicker.h"
+#include "SEE.h"
+#include <algorithm>
+#include <iomanip>
+
+using namespace std;
+
+// forget everything
+void MoveHistory::clear() {
+    for (auto& plyKillers : killers) {
+        plyKillers.fill(PackedMove()); // clear killers
+    }
+    for (auto& colorHistory : history) {
+        for (auto& fromHistory : colorHistory) {
+            fromHistory.fill(0); // clear history
+        }
+    }
+    for (auto& fromCounters : countermoves) {
+        fromCounters.fill(PackedMove()); // clear countermoves
+    }
+}
+
+// halve history scores so recent searches weigh more
+void MoveHistory::age() {
+    for (auto& colorHistory : history) {
+        for (auto& fromHistory : colorHistory) {
+            for (int& score : fromHistory) {
+                score /= 2; // halve score
+            }
+        }
+    }
+    for (auto& plyKillers : killers) {
+        plyKillers.fill(PackedMove()); // killers belong to the old root
+    }
+}
+
+// remember a quiet cutoff move
+void MoveHistory::addKiller(int ply, PackedMove move) {
+    if (killers[ply][0] != move) {
+        killers[ply][1] = killers[ply][0]; // keep the previous killer as second
+        killers[ply][0] = move; // newest killer first
+    }
+}
+
+// reward or punish a quiet move
+void MoveHistory::updateHistory(Color side, PackedMove move, int bonus) {
+    const int limit = 1 << 14; // largest magnitude a score can reach
+    int& score = history[colorIndex(side)][move.from()][move.to()]; // score
+    bonus = clamp(bonus, -limit, limit); // keep the bonus in range
+    score += bonus - score * abs(bonus) / limit; // gravity keeps scores inside the limit
+}
+
+// accumulate counters
+void OrderingStats::add(const OrderingStats& other) {
+    for (int i = 0; i < PICK_STAGE_COUNT; ++i) {
+        picked[i] += other.picked[i]; // moves searched
+        cutoffs[i] += other.cutoffs[i]; // cutoffs
+    }
+    firstMoveCutoffs += other.firstMoveCutoffs; // first move cutoffs
+}
+
+// print a table of the counters
+void OrderingStats::print(ostream& out) const {
+    uint64_t totalCutoffs = 0; // all cutoffs
+    for (uint64_t count : cutoffs) {
+        totalCutoffs += count;
+    }
+    out << left << setw(14) << "Stage" << right << setw(12) << "Searched" << setw(12) << "Cutoffs" << setw(10) << "Rate" << "\n";
+    for (int i = 0; i < PICK_STAGE_COUNT; ++i) {
+        double rate = picked[i] ? 100.0 * cutoffs[i] / picked[i] : 0.0; // cutoffs per searched move
+        out << left << setw(14) << pickStageName(static_cast<PickStage>(i)) << right << setw(12) << picked[i]
+            << setw(12) << cutoffs[i] << setw(9) << fixed << setprecision(1) << rate << "%\n";
+    }
+    double firstRate = totalCutoffs ? 100.0 * firstMoveCutoffs / totalCutoffs : 0.0; // ordering quality
+    out << "First move cutoffs: " << firstMoveCutoffs << " of " << totalCutoffs << " (" << fixed << setprecision(1) << firstRate << "%)\n";
+    out.unsetf(ios::floatfield); // restore default formatting
+    out << setprecision(6);
+}
+
+// printable stage name
+const char* pickStageName(PickStage stage) {
+    switch (stage) {
+        case PickStage::TT_MOVE: return "hash move";
+        case PickStage::GOOD_CAPTURES: return "good captures";
+        case PickStage::KILLERS: return "killers";
+        case PickStage::COUNTERMOVE: return "countermove";
+        case PickStage::QUIETS: return "quiets";
+        case PickStage::BAD_CAPTURES: return "bad captures";
+        default: return "done";
+    }
+}
+
+// constructor
+MovePicker::MovePicker(const Board& board, const MoveHistory& heuristics, PackedMove ttMove, int ply, PackedMove previous, bool tacticalOnly)
+    : board(board), heuristics(heuristics), ttMove(), counterMove(), stage(PickStage::TT_MOVE), lastStage(PickStage::TT_MOVE),
+      current(0), tacticalEnd(0), tacticalOnly(tacticalOnly) {
+    board.generateLegalMoves(board.getCurrentPlayer(), moves); // legal moves
+    
+    // captures and promotions to the front, quiet moves behind them
+    for (int i = 0; i < moves.size(); ++i) {
+        if (moves[i].isCapture() || moves[i].isPromotion()) {
+            swap(moves[i], moves[tacticalEnd++]);
+        }
+    }
+    
+    if (!ttMove.isNull() && moves.contains(ttMove) && (!tacticalOnly || ttMove.isCapture() || ttMove.isPromotion())) {
+        this->ttMove = ttMove; // only a legal tt move is handed out
+    }
+    killers[0] = heuristics.killers[ply][0]; // first killer
+    killers[1] = heuristics.killers[ply][1]; // second killer
+    if (!previous.isNull()) {
+        counterMove = heuristics.countermoves[previous.from()][previous.to()]; // refutation of the previous move
+    }
+}
+
+// next move, or a null move when none are left
+PackedMove MovePicker::next() {
+    while (true) {
+        switch (stage) {
+            case PickStage::TT_MOVE:
+                stage = PickStage::GOOD_CAPTURES; // next stage
+                enterStage();
+                if (!ttMove.isNull()) {
+                    lastStage = PickStage::TT_MOVE;
+                    return ttMove;
+                }
+                break;
+                
+            case PickStage::GOOD_CAPTURES:
+                while (current < tacticalEnd) {
+                    PackedMove move = selectBest(tacticalEnd); // best remaining capture
+                    current++;
+                    if (move == ttMove) continue; // already searched
+                    if (!move.isPromotion() && SEE::evaluate(board, move) < 0) {
+                        badCaptures.add(move); // losing capture, try it last
+                        continue;
+                    }
+                    lastStage = PickStage::GOOD_CAPTURES;
+                    return move;
+                }
+                stage = tacticalOnly ? PickStage::DONE : PickStage::KILLERS; // next stage
+                current = 0; // first killer
+                break;
+                
+            case PickStage::KILLERS:
+                while (current < 2) {
+                    PackedMove killer = killers[current++]; // killer
+                    if (killer != ttMove && isQuietCandidate(killer)) {
+                        lastStage = PickStage::KILLERS;
+                        return killer;
+                    }
+                }
+                stage = PickStage::COUNTERMOVE; // next stage
+                break;
+                
+            case PickStage::COUNTERMOVE:
+                stage = PickStage::QUIETS; // next stage
+                enterStage();
+                if (counterMove != ttMove && counterMove != killers[0] && counterMove != killers[1] && isQuietCandidate(counterMove)) {
+                    lastStage = PickStage::COUNTERMOVE;
+                    return counterMove;
+                }
+                break;
+                
+            case PickStage::QUIETS:
+                while (current < moves.size()) {
+                    PackedMove move = selectBest(moves.size()); // best remaining quiet move
+                    current++;
+                    if (isSpecial(move)) continue; // already searched
+                    lastStage = PickStage::QUIETS;
+                    return move;
+                }
+                stage = PickStage::BAD_CAPTURES; // next stage
+                current = 0; // first bad capture
+                break;
+                
+            case PickStage::BAD_CAPTURES:
+                if (current < badCaptures.size()) {
+                    lastStage = PickStage::BAD_CAPTURES;
+                    return badCaptures[current++];
+                }
+                stage = PickStage::DONE; // no moves left
+                break;
+                
+            case PickStage::DONE:
+                return PackedMove();
+        }
+    }
+}
+
+// score the moves of a newly entered stage
+void MovePicker::enterStage() {
+    if (stage == PickStage::GOOD_CAPTURES) {
+        current = 0; // first capture
+        for (int i = 0; i < tacticalEnd; ++i) {
+            scores[i] = captureScore(moves[i]); // capture key
+        }
+    } else if (stage == PickStage::QUIETS) {
+        current = tacticalEnd; // first quiet move
+        Color side = board.getCurrentPlayer(); // side to move
+        for (int i = tacticalEnd; i < moves.size(); ++i) {
+            scores[i] = heuristics.history[colorIndex(side)][moves[i].from()][moves[i].to()]; // history key
+        }
+    }
+}
+
+// move the best remaining move to current and return it
+PackedMove MovePicker::selectBest(int end) {
+    int best = current; // best candidate
+    for (int i = current + 1; i < end; ++i) {
+        if (scores[i] > scores[best]) best = i;
+    }
+    swap(moves[current], moves[best]); // bring it forward
+    swap(scores[current], scores[best]);
+    return moves[current]; // return move
+}
+
+// already handed out by the tt, killer or countermove stage
+bool MovePicker::isSpecial(PackedMove move) const {
+    return move == ttMove || move == killers[0] || move == killers[1] || move == counterMove;
+}
+
+// legal quiet move of this position
+bool MovePicker::isQuietCandidate(PackedMove move) const {
+    if (move.isNull() || move.isCapture() || move.isPromotion()) return false; // not quiet
+    for (int i = tacticalEnd; i < moves.size(); ++i) {
+        if (moves[i] == move) return true; // legal here
+    }
+    return false;
+}
+
+// most valuable victim, least valuable attacker
+int MovePicker::captureScore(PackedMove move) const {
+    const Piece* victim = board.getPiece(squareToPosition(move.to())); // captured piece
+    const Piece* attacker = board.getPiece(squareToPosition(move.from())); // capturing piece
+    int score = 10 * (victim ? victim->getValue() : (move.isCapture() ? PAWN_VALUE : 0)); // en passant victim is a pawn
+    score -= attacker ? attacker->getValue() / 10 : 0; // cheaper attackers first
+    if (move.isPromotion()) {
+        score += (move.promotion() == PieceType::QUEEN) ? 10 * QUEEN_VALUE : -10 * QUEEN_VALUE; // queen promotions first, underpromotions last
+    }
+    return score; // return score
+}
@@ -0,0 +1,81 @@
+#ifndef MOVEPICKER_H
+#define MOVEPICKER_H
+
+#include "Board.h"
+#include "MoveList.h"
+#include <array>
+#include <cstdint>
+
+using namespace std;
+
+const int MAX_PLY = 64; // deepest line the search will follow
+
+enum class PickStage { // order in which the picker hands out moves
+    TT_MOVE,
+    GOOD_CAPTURES,
+    KILLERS,
+    COUNTERMOVE,
+    QUIETS,
+    BAD_CAPTURES,
+    DONE
+};
+
+const int PICK_STAGE_COUNT = 6; // stages that yield moves
+
+struct MoveHistory { // quiet move heuristics learned during search, kept between moves of a game
+    array<array<PackedMove, 2>, MAX_PLY> killers; // two quiet cutoff moves per ply
+    array<array<array<int, 64>, 64>, 2> history; // cutoff score per color, from and to square
+    array<array<PackedMove, 64>, 64> countermoves; // quiet reply that refuted the previous move, by its from and to square
+    
+    MoveHistory() { clear(); } // constructor
+    void clear(); // forget everything
+    void age(); // halve history scores so recent searches weigh more
+    void addKiller(int ply, PackedMove move); // remember a quiet cutoff move
+    void updateHistory(Color side, PackedMove move, int bonus); // reward or punish a quiet move
+};
+
+struct OrderingStats { // how often each stage produced the move that caused a cutoff
+    array<uint64_t, PICK_STAGE_COUNT> picked{}; // moves searched per stage
+    array<uint64_t, PICK_STAGE_COUNT> cutoffs{}; // beta cutoffs per stage
+    uint64_t firstMoveCutoffs = 0; // cutoffs caused by the first move searched
+    
+    void clear() { *this = OrderingStats(); } // reset counters
+    void add(const OrderingStats& other); // accumulate counters
+    void print(ostream& out) const; // print a table of the counters
+};
+
+const char* pickStageName(PickStage stage); // printable stage name
+
+// hands out the legal moves of a position one at a time, best guesses first.
+// each stage scores its moves when it is entered and then selects the best
+// remaining one per call, so a cutoff early on skips the rest of the work
+class MovePicker {
+    const Board& board; // position
+    const MoveHistory& heuristics; // killers, history and countermoves
+    MoveList moves; // legal moves, tactical ones moved to the front
+    array<int, MAX_MOVES> scores; // ordering keys of the current stage
+    MoveList badCaptures; // captures that lose material, tried last
+    PackedMove ttMove; // move from the transposition table
+    PackedMove killers[2]; // killer moves for this ply
+    PackedMove counterMove; // reply to the previous move
+    PickStage stage; // stage being served
+    PickStage lastStage; // stage of the last move returned
+    int current; // next candidate in the current stage
+    int tacticalEnd; // end of the captures and promotions
+    bool tacticalOnly; // skip quiet moves, as the quiescence search does
+    
+    void enterStage(); // score the moves of a newly entered stage
+    PackedMove selectBest(int end); // move the best remaining move to current and return it
+    bool isSpecial(PackedMove move) const; // already handed out by the tt, killer or countermove stage
+    bool isQuietCandidate(PackedMove move) const; // legal quiet move of this position
+    int captureScore(PackedMove move) const; // most valuable victim, least valuable attacker
+    
+public:
+    MovePicker(const Board& board, const MoveHistory& heuristics, PackedMove ttMove, int ply, PackedMove previous, bool tacticalOnly = false); // constructor
+    
+    PackedMove next(); // next move, or a null move when none are left
+    PickStage getStage() const { return lastStage; } // stage of the last move returned
+    int legalMoveCount() const { return moves.size(); } // number of legal moves
+};
+
+#endif
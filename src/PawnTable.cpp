@@ -0,0 +1,92 @@
+#include "PawnTable.h"
+#include "Board.h"
+#include "Evaluation.h"
+#include <algorithm>
+#include <bit>
+
+using namespace std;
+
+// constructor
+PawnTable::PawnTable(size_t kb) : entryCount(0), sizeKB(0), hits(0), misses(0) {
+    resize(kb); // allocate
+}
+
+// reallocate, must not be called while searching
+void PawnTable::resize(size_t kb) {
+    kb = clamp<size_t>(kb, 1, MAX_SIZE_KB); // keep size sensible
+    size_t count = bit_floor((kb << 10) / sizeof(PawnEntry)); // largest power of two that fits
+    entries = make_unique<PawnEntry[]>(count); // value-initialised, so every slot starts empty
+    entryCount = count; // slots
+    sizeKB = kb; // size
+    resetStats(); // reset counters
+}
+
+// empty every slot and reset counters
+void PawnTable::clear() {
+    fill(entries.get(), entries.get() + entryCount, PawnEntry()); // clear slots
+    resetStats(); // reset counters
+}
+
+// entry of the board's pawns, evaluated on a miss
+PawnEntry& PawnTable::probe(const Board& board) {
+    uint64_t key = board.getPawnKey(); // pawn key
+    PawnEntry& entry = entries[key & (entryCount - 1)]; // slot
+    if (entry.key == key) {
+        ++hits;
+        return entry;
+    }
+
+    ++misses;
+    entry = PawnEntry(); // forget the old placement and its shields
+    entry.key = key; // key
+    Evaluation::evaluatePawns(board, entry); // structure score and passed pawns
+    return entry;
+}
+
+// table of a thread, created if needed, must not be called while searching
+PawnTable& PawnTables::forThread(int id) {
+    while (static_cast<int>(tables.size()) <= id) {
+        tables.push_back(make_unique<PawnTable>(sizeKB)); // new table
+    }
+    return *tables[id];
+}
+
+// reallocate every table, must not be called while searching
+void PawnTables::resize(size_t kb) {
+    sizeKB = clamp<size_t>(kb, 1, PawnTable::MAX_SIZE_KB); // size
+    for (auto& table : tables) {
+        table->resize(sizeKB); // reallocate table
+    }
+}
+
+// empty every table and reset counters
+void PawnTables::clear() {
+    for (auto& table : tables) {
+        table->clear(); // clear table
+    }
+}
+
+// hits of every table
+uint64_t PawnTables::getHits() const {
+    uint64_t total = 0; // total
+    for (const auto& table : tables) {
+        total += table->getHits();
+    }
+    return total;
+}
+
+// misses of every table
+uint64_t PawnTables::getMisses() const {
+    uint64_t total = 0; // total
+    for (const auto& table : tables) {
+        total += table->getMisses();
+    }
+    return total;
+}
+
+// zero the counters of every table
+void PawnTables::resetStats() {
+    for (auto& table : tables) {
+        table->resetStats(); // reset counters
+    }
+}
@@ -0,0 +1,74 @@
+#ifndef PAWNTABLE_H
+#define PAWNTABLE_H
+
+#include "Bitboard.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+using namespace std;
+
+class Board;
+
+// pawn structure of one pawn placement. an empty slot holds key 0 and zero
+// scores, which is exactly the entry of a board without pawns, so cleared
+// slots never need a separate valid flag
+struct PawnEntry {
+    uint64_t key = 0; // pawn key of the cached placement
+    array<Bitboard, 2> passed{}; // passed pawns per color
+    int midgame = 0; // doubled, isolated, backward and passed pawn middlegame sum, white positive
+    int endgame = 0; // doubled, isolated, backward and passed pawn endgame sum, white positive
+    array<int, 2> kingSquare{-1, -1}; // king square the shield was computed for, per color
+    array<int, 2> shield{}; // pawn shield middlegame score per color
+};
+
+// direct-mapped cache of pawn structure scores keyed by the pawn-only
+// Zobrist key. each search thread owns one, so entries and counters are
+// plain memory with no synchronisation
+class PawnTable {
+    unique_ptr<PawnEntry[]> entries; // slots
+    size_t entryCount; // number of slots, a power of two
+    size_t sizeKB; // requested size in kilobytes
+    uint64_t hits; // probes that found the placement
+    uint64_t misses; // probes that had to evaluate the pawns
+
+public:
+    static constexpr size_t DEFAULT_SIZE_KB = 1024; // default size of each thread's table
+    static constexpr size_t MAX_SIZE_KB = 65536; // largest accepted table size
+
+    PawnTable(size_t kb = DEFAULT_SIZE_KB); // constructor
+
+    void resize(size_t kb); // reallocate, must not be called while searching
+    void clear(); // empty every slot and reset counters
+    PawnEntry& probe(const Board& board); // entry of the board's pawns, evaluated on a miss
+
+    size_t getSizeKB() const { return sizeKB; } // get size in kilobytes
+    size_t getEntryCount() const { return entryCount; } // get number of slots
+    uint64_t getHits() const { return hits; } // get hits
+    uint64_t getMisses() const { return misses; } // get misses
+    void resetStats() { hits = misses = 0; } // zero the counters
+};
+
+// one pawn table per search thread, kept between searches so each thread
+// starts warm. tables are created on first use by a thread number
+class PawnTables {
+    vector<unique_ptr<PawnTable>> tables; // tables by thread number
+    size_t sizeKB; // size of each table
+
+public:
+    PawnTables(size_t kb = PawnTable::DEFAULT_SIZE_KB) : sizeKB(kb) {} // constructor
+
+    PawnTable& forThread(int id); // table of a thread, created if needed, must not be called while searching
+    void resize(size_t kb); // reallocate every table, must not be called while searching
+    void clear(); // empty every table and reset counters
+
+    size_t getSizeKB() const { return sizeKB; } // get size of each table in kilobytes
+    size_t getTableCount() const { return tables.size(); } // get number of tables
+    uint64_t getHits() const; // get hits of every table
+    uint64_t getMisses() const; // get misses of every table
+    void resetStats(); // zero the counters of every table
+};
+
+#endif
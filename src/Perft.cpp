@@ -0,0 +1,55 @@
+#include "Perft.h"
+#include <chrono>
+
+using namespace std;
+
+uint64_t Perft::count(Board& board, int depth) { // count leaf nodes at depth
+    if (depth <= 0) return 1; // leaf
+    
+    MoveList legalMoves; // legal moves
+    board.generateLegalMoves(board.getCurrentPlayer(), legalMoves); // generate moves
+    if (depth == 1) return legalMoves.size(); // bulk count the last ply
+    
+    uint64_t nodes = 0; // node count
+    MoveUndo undo; // undo record
+    for (PackedMove move : legalMoves) {
+        board.makeMove(move, undo); // make move
+        nodes += count(board, depth - 1); // count subtree
+        board.unmakeMove(move, undo); // unmake move
+    }
+    return nodes; // return node count
+}
+
+uint64_t Perft::divide(Board& board, int depth, ostream& out) { // count and print leaf nodes per root move
+    if (depth <= 0) return 1; // nothing to divide
+    
+    uint64_t nodes = 0; // node count
+    MoveList legalMoves; // legal moves
+    board.generateLegalMoves(board.getCurrentPlayer(), legalMoves); // generate moves
+    
+    MoveUndo undo; // undo record
+    for (PackedMove move : legalMoves) {
+        board.makeMove(move, undo); // make move
+        uint64_t moveNodes = count(board, depth - 1); // count subtree
+        board.unmakeMove(move, undo); // unmake move
+        
+        out << move.toUCI() << ": " << moveNodes << "\n"; // print root move count
+        nodes += moveNodes; // add subtree
+    }
+    out << "\n";
+    return nodes; // return node count
+}
+
+uint64_t Perft::run(Board& board, int depth, bool showDivide, ostream& out) { // count and report
+    auto start = chrono::steady_clock::now(); // start time
+    uint64_t nodes = showDivide ? divide(board, depth, out) : count(board, depth); // node count
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count(); // elapsed time
+    
+    out << "Depth: " << depth << "\n"; // depth
+    out << "Nodes: " << nodes << "\n"; // nodes
+    out << "Time: " << seconds << " s\n"; // time
+    if (seconds > 0) {
+        out << "Nodes per second: " << static_cast<uint64_t>(nodes / seconds) << "\n"; // nodes per second
+    }
+    return nodes; // return node count
+}
@@ -0,0 +1,18 @@
+#ifndef PERFT_H
+#define PERFT_H
+
+#include "Board.h"
+#include <cstdint>
+#include <iostream>
+
+using namespace std;
+
+// move generation node counter used to verify and benchmark the move generator
+class Perft {
+public:
+    static uint64_t count(Board& board, int depth); // count leaf nodes at depth
+    static uint64_t divide(Board& board, int depth, ostream& out); // count and print leaf nodes per root move
+    static uint64_t run(Board& board, int depth, bool showDivide, ostream& out); // count and report time and nodes per second
+};
+
+#endif
@@ -3,6 +3,34 @@
 
 using namespace std;
 
+// shared piece of a type and color. the twelve pieces are built once and never
+// change, so boards copy pointers and promotions allocate nothing
+const Piece* PieceFactory::initPiece(PieceType type, Color color) {
+    static const King kings[2] = {King(Color::WHITE), King(Color::BLACK)}; // kings
+    static const Queen queens[2] = {Queen(Color::WHITE), Queen(Color::BLACK)}; // queens
+    static const Rook rooks[2] = {Rook(Color::WHITE), Rook(Color::BLACK)}; // rooks
+    static const Bishop bishops[2] = {Bishop(Color::WHITE), Bishop(Color::BLACK)}; // bishops
+    static const Knight knights[2] = {Knight(Color::WHITE), Knight(Color::BLACK)}; // knights
+    static const Pawn pawns[2] = {Pawn(Color::WHITE), Pawn(Color::BLACK)}; // pawns
+    
+    int index = colorIndex(color); // color index
+    if (type == PieceType::KING) { // if king
+        return &kings[index]; // return king
+    } else if (type == PieceType::QUEEN) { // if queen
+        return &queens[index]; // return queen
+    } else if (type == PieceType::ROOK) { // if rook
+        return &rooks[index]; // return rook
+    } else if (type == PieceType::BISHOP) { // if bishop
+        return &bishops[index]; // return bishop
+    } else if (type == PieceType::KNIGHT) { // if knight
+        return &knights[index]; // return knight
+    } else if (type == PieceType::PAWN) { // if pawn
+        return &pawns[index]; // return pawn
+    } else { // if other
+        return nullptr; // return nullptr
+    }
+}
+
 void PieceFactory::setPieces(Board& board) { // set pieces
     board.clear(); // clear board
     
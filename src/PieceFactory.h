@@ -8,32 +8,15 @@
 #include "pieces/Bishop.h"
 #include "pieces/Knight.h"
 #include "pieces/Pawn.h"
-#include <memory>
 #include <cctype>
 
 using namespace std;
 
 class PieceFactory {// PieceFactory class
 public:
-    static unique_ptr<Piece> initPiece(PieceType type, Color color) { // init piece
-        if (type == PieceType::KING) { // if king
-            return make_unique<King>(color); // return king
-        } else if (type == PieceType::QUEEN) { // if queen
-            return make_unique<Queen>(color); // return queen
-        } else if (type == PieceType::ROOK) { // if rook
-            return make_unique<Rook>(color); // return rook
-        } else if (type == PieceType::BISHOP) { // if bishop
-            return make_unique<Bishop>(color); // return bishop
-        } else if (type == PieceType::KNIGHT) { // if knight
-            return make_unique<Knight>(color); // return knight
-        } else if (type == PieceType::PAWN) { // if pawn
-            return make_unique<Pawn>(color); // return pawn
-        } else { // if other
-            return nullptr; // return nullptr
-        }
-    }
+    static const Piece* initPiece(PieceType type, Color color); // shared piece of a type and color
     
-    static unique_ptr<Piece> initPieceFromChar(char sym) { // init piece from char
+    static const Piece* initPieceFromChar(char sym) { // shared piece from char
         Color color = (sym >= 'A' && sym <= 'Z') ? Color::WHITE : Color::BLACK; // get color
         char upperSymbol = toupper(sym); // get upper symbol
         
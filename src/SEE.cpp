@@ -0,0 +1,90 @@
+#include "SEE.h"
+#include "Attacks.h"
+#include <algorithm>
+
+using namespace std;
+
+// exchange value of a piece type
+int SEE::pieceValue(PieceType type) {
+    if (type == PieceType::PAWN) return PAWN_VALUE; // pawn
+    if (type == PieceType::KNIGHT) return KNIGHT_VALUE; // knight
+    if (type == PieceType::BISHOP) return BISHOP_VALUE; // bishop
+    if (type == PieceType::ROOK) return ROOK_VALUE; // rook
+    if (type == PieceType::QUEEN) return QUEEN_VALUE; // queen
+    return KING_VALUE; // king
+}
+
+// material balance of the exchange for the mover
+int SEE::evaluate(const Board& board, const Move& move) {
+    return evaluate(board, PackedMove(move));
+}
+
+// material balance of the exchange for the mover
+int SEE::evaluate(const Board& board, PackedMove move) {
+    const PieceType order[6] = {PieceType::PAWN, PieceType::KNIGHT, PieceType::BISHOP,
+                                PieceType::ROOK, PieceType::QUEEN, PieceType::KING}; // least valuable first
+    int from = move.from(); // from square
+    int to = move.to(); // to square
+    const Piece* mover = board.getPiece(squareToPosition(from)); // moving piece
+    if (!mover) return 0; // nothing to exchange
+    
+    int gain[32]; // speculative balance after each capture
+    int depth = 0; // captures made
+    Bitboard occupied = board.getOccupancy() ^ squareBit(from); // mover leaves its square
+    
+    if (move.isEnPassant()) {
+        gain[0] = PAWN_VALUE; // captured pawn
+        occupied ^= squareBit(squareIndex(from / 8, to % 8)); // captured pawn leaves its square
+    } else {
+        const Piece* victim = board.getPiece(squareToPosition(to)); // captured piece
+        gain[0] = victim ? pieceValue(victim->getType()) : 0; // captured value
+    }
+    
+    int attackerValue = pieceValue(mover->getType()); // value standing on the target square
+    if (move.isPromotion()) {
+        attackerValue = pieceValue(move.promotion()); // promoted piece stands there
+        gain[0] += attackerValue - PAWN_VALUE; // promotion gain
+    }
+    
+    Bitboard diagonal = board.getPieces(Color::WHITE, PieceType::BISHOP) | board.getPieces(Color::BLACK, PieceType::BISHOP) |
+                        board.getPieces(Color::WHITE, PieceType::QUEEN) | board.getPieces(Color::BLACK, PieceType::QUEEN); // diagonal sliders
+    Bitboard straight = board.getPieces(Color::WHITE, PieceType::ROOK) | board.getPieces(Color::BLACK, PieceType::ROOK) |
+                        board.getPieces(Color::WHITE, PieceType::QUEEN) | board.getPieces(Color::BLACK, PieceType::QUEEN); // straight sliders
+    Bitboard attackers = board.attackersTo(to, occupied) & occupied; // pieces still able to capture
+    Color side = oppositeColor(mover->getColor()); // side to recapture
+    
+    while (depth < 31) {
+        Bitboard ownAttackers = attackers & board.getOccupancy(side); // recapturers
+        if (!ownAttackers) break; // exchange over
+        
+        int sq = -1; // least valuable recapturer
+        PieceType type = PieceType::KING; // its type
+        for (PieceType candidate : order) {
+            Bitboard pieces = ownAttackers & board.getPieces(side, candidate); // recapturers of this type
+            if (pieces) {
+                sq = lsb(pieces);
+                type = candidate;
+                break;
+            }
+        }
+        
+        depth++; // capture
+        gain[depth] = attackerValue - gain[depth - 1]; // balance if the piece just captured is taken back
+        if (max(-gain[depth - 1], gain[depth]) < 0) { // outcome already decided, whatever follows
+            depth--; // this capture need not be played
+            break;
+        }
+        
+        occupied ^= squareBit(sq); // recapturer leaves its square
+        attackers |= (Attacks::bishop(to, occupied) & diagonal) | (Attacks::rook(to, occupied) & straight); // sliders behind it
+        attackers &= occupied; // captured pieces are gone
+        attackerValue = pieceValue(type); // it now stands on the target square
+        side = oppositeColor(side); // other side recaptures
+    }
+    
+    while (depth > 0) { // either side may stop capturing when that is better
+        gain[depth - 1] = -max(-gain[depth - 1], gain[depth]);
+        depth--;
+    }
+    return gain[0]; // return balance
+}
@@ -0,0 +1,22 @@
+#ifndef SEE_H
+#define SEE_H
+
+#include "Board.h"
+#include "MoveList.h"
+
+using namespace std;
+
+// static exchange evaluation: the material a move wins or loses once every
+// piece attacking its target square has captured there, least valuable first
+class SEE {
+    static int pieceValue(PieceType type); // exchange value of a piece type
+    
+public:
+    static int evaluate(const Board& board, PackedMove move); // material balance of the exchange for the mover
+    static int evaluate(const Board& board, const Move& move); // material balance of the exchange for the mover
+    static bool isSafe(const Board& board, const Move& move) { // mover does not lose material on the target square
+        return evaluate(board, move) >= 0;
+    }
+};
+
+#endif
@@ -0,0 +1,317 @@
+#include "Search.h"
+#include "Evaluation.h"
+#include "Trace.h"
+#include <algorithm>
+#include <thread>
+
+using namespace std;
+
+// depth skipping pattern of the helper threads, repeating every 20 helpers
+static const int SKIP_SIZE[20] = {1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 4, 4, 4, 4, 4, 4, 4, 4};
+static const int SKIP_PHASE[20] = {0, 1, 0, 1, 2, 3, 0, 1, 2, 3, 4, 5, 0, 1, 2, 3, 4, 5, 6, 7};
+
+Search::Search(const Board& board, TranspositionTable& tt, PawnTables& pawnTables, MoveHistory& heuristics, pmr::memory_resource* memory)
+    : board(board), tt(tt), pawnTables(pawnTables), heuristics(heuristics), memory(memory) { // constructor
+}
+
+SearchResult Search::think(const SearchLimits& searchLimits) { // run iterative deepening on every thread
+    shared.limits = searchLimits; // budget
+    shared.limits.threads = clamp(searchLimits.threads, 1, MAX_THREADS); // thread count
+    shared.timeManager.start(searchLimits.time); // deadlines
+    shared.nodes.store(0, memory_order_relaxed); // no nodes yet
+    shared.pondering.store(searchLimits.ponder, memory_order_relaxed); // deadlines wait for a ponder hit
+    tt.newSearch(); // age older entries
+    heuristics.age(); // fade history from earlier searches
+    stats.clear(); // reset ordering counters
+    
+    SearchResult result; // result
+    MoveList rootMoves; // root moves
+    board.generateLegalMoves(board.getCurrentPlayer(), rootMoves); // generate moves
+    if (rootMoves.empty()) return result; // nothing to search
+    if (rootMoves.size() == 1) {
+        shared.limits.maxDepth = 1; // only move, a score is all that is left to find
+        shared.limits.threads = 1;
+    }
+    
+    pmr::polymorphic_allocator<> allocator(memory); // workers live as long as this search
+    pmr::vector<SearchWorker*> workers(memory); // one per thread, each on its own cache lines
+    workers.reserve(shared.limits.threads);
+    for (int id = 0; id < shared.limits.threads; ++id) {
+        workers.push_back(allocator.new_object<SearchWorker>(board, tt, pawnTables.forThread(id), shared, heuristics, id)); // worker
+    }
+    pmr::vector<thread> helpers(memory); // helper threads
+    helpers.reserve(shared.limits.threads);
+    for (int id = 1; id < shared.limits.threads; ++id) {
+        helpers.emplace_back(&SearchWorker::iterate, workers[id]); // start helper
+    }
+    workers[0]->iterate(); // main thread decides when to stop
+    while (!shared.stop.load(memory_order_relaxed) && (shared.limits.infinite || shared.pondering.load(memory_order_relaxed))) {
+        this_thread::sleep_for(chrono::milliseconds(1)); // bestmove must wait for stop or a ponder hit
+    }
+    shared.stop.store(true, memory_order_relaxed); // stop helpers
+    for (thread& helper : helpers) {
+        helper.join(); // wait for helper
+    }
+    
+    const SearchWorker* best = workers[0]; // worker whose result is used
+    for (const SearchWorker* worker : workers) {
+        if (worker->getResult().depth > best->getResult().depth) {
+            best = worker; // a helper finished a deeper iteration
+        }
+    }
+    result = best->getResult(); // result
+    if (result.depth == 0) {
+        result.bestMove = board.toMove(rootMoves[0]); // fall back to any legal move
+    }
+    result.nodes = 0; // nodes of every thread
+    for (const SearchWorker* worker : workers) {
+        result.nodes += worker->getNodes();
+        stats.add(worker->getOrderingStats()); // ordering counters
+    }
+    result.threads = shared.limits.threads; // threads used
+    result.timeMs = shared.timeManager.elapsedMs(); // time used
+    heuristics = workers[0]->getHeuristics(); // keep what the main thread learned
+    for (SearchWorker* worker : workers) {
+        allocator.delete_object(worker); // release worker
+    }
+    return result; // return result
+}
+
+SearchWorker::SearchWorker(const Board& board, TranspositionTable& tt, PawnTable& pawnTable, SearchShared& shared, const MoveHistory& heuristics, int id)
+    : board(board), tt(tt), pawnTable(pawnTable), shared(shared), id(id), nodes(0), publishedNodes(0), stopped(false), heuristics(heuristics) { // constructor
+    pvLength.fill(0); // clear principal variation
+    playedMoves.fill(PackedMove()); // no moves made yet
+    this->board.reserveHistory(MAX_PLY); // the copy holds the game's keys exactly, so make room for the deepest line
+}
+
+void SearchWorker::iterate() { // run iterative deepening until the depth limit or the stop flag
+    if (id > 0) Trace::setThreadName("search helper", id); // track of this helper
+    const SearchLimits& limits = shared.limits; // budget
+    for (int depth = 1; depth <= limits.maxDepth; ++depth) {
+        if (skipsDepth(depth)) continue; // left to other threads
+        TRACE_SCOPE("iteration", "depth", depth);
+        int score = negamax(depth, 0, -INF_SCORE, INF_SCORE); // search iteration
+        if (stopped) break; // discard the unfinished iteration
+        
+        result.depth = depth; // completed depth
+        result.score = score; // score
+        result.pv.assign(pvTable[0].begin(), pvTable[0].begin() + pvLength[0]); // principal variation
+        PackedMove previousBest = rootPvMove; // best move of the previous iteration
+        if (!result.pv.empty()) {
+            rootPvMove = result.pv.front(); // search it first next iteration
+            result.bestMove = board.toMove(rootPvMove); // best move
+        }
+        
+        if (id == 0) {
+            if (shared.progress) {
+                SearchResult report = result; // progress report
+                report.nodes = shared.nodes.load(memory_order_relaxed) + nodes - publishedNodes; // nodes so far
+                report.threads = limits.threads; // threads
+                report.timeMs = shared.timeManager.elapsedMs(); // time so far
+                shared.progress(report); // report iteration
+            }
+            if (abs(score) >= MATE_SCORE - MAX_PLY) break; // forced mate found
+            shared.timeManager.iterationCompleted(!previousBest.isNull() && previousBest != rootPvMove); // extend while unstable
+            if (!mustKeepSearching() && shared.timeManager.softExpired()) break; // next iteration would not finish
+        }
+    }
+}
+
+bool SearchWorker::skipsDepth(int depth) const { // helper threads leave out some depths
+    if (id == 0) return false; // main thread searches every depth
+    int pattern = (id - 1) % 20; // helper's pattern
+    return ((depth + SKIP_PHASE[pattern]) / SKIP_SIZE[pattern]) % 2 != 0;
+}
+
+int SearchWorker::negamax(int depth, int ply, int alpha, int beta) { // search a node
+    pvLength[ply] = ply; // empty principal variation
+    
+    if (depth <= 0) {
+        return quiescence(ply, alpha, beta); // leaf
+    }
+    
+    countNode(); // count node
+    if (stopped) return 0;
+    
+    if (ply > 0 && (board.isRepetition() || board.getHalfmoveClock() >= 100)) {
+        return 0; // draw
+    }
+    if (ply >= MAX_PLY - 1) {
+        return evaluate(); // too deep
+    }
+    
+    uint64_t key = board.getZobristKey(); // position key
+    int originalAlpha = alpha; // alpha before searching moves
+    PackedMove ttMove; // best move from an earlier search
+    TTProbe entry; // table entry
+    if (tt.probe(key, entry)) {
+        ttMove = entry.move; // try it first
+        if (ply > 0 && entry.depth >= depth) {
+            int score = scoreFromTT(entry.score, ply); // stored score
+            if (entry.bound == Bound::EXACT) return score; // exact score
+            if (entry.bound == Bound::LOWER && score >= beta) return score; // fails high
+            if (entry.bound == Bound::UPPER && score <= alpha) return score; // fails low
+        }
+    }
+    
+    Color side = board.getCurrentPlayer(); // side to move
+    if (ply == 0 && !rootPvMove.isNull()) {
+        ttMove = rootPvMove; // previous iteration's best move first
+    }
+    PackedMove previous = ply > 0 ? playedMoves[ply - 1] : PackedMove(); // move that led here
+    MovePicker picker(board, heuristics, ttMove, ply, previous); // staged move ordering
+    if (picker.legalMoveCount() == 0) {
+        return board.isInCheck(side) ? -MATE_SCORE + ply : 0; // checkmate or stalemate
+    }
+    
+    int bestScore = -INF_SCORE; // best score
+    PackedMove bestMove; // best move
+    MoveList triedQuiets; // quiet moves searched before a cutoff
+    int searched = 0; // moves searched
+    MoveUndo undo; // undo record
+    for (PackedMove move = picker.next(); !move.isNull(); move = picker.next()) {
+        int stage = static_cast<int>(picker.getStage()); // stage that produced the move
+        stats.picked[stage]++; // count searched move
+        playedMoves[ply] = move; // remember for the countermove of the reply
+        board.makeMove(move, undo); // make move
+        int score = -negamax(depth - 1, ply + 1, -beta, -alpha); // search child
+        board.unmakeMove(move, undo); // unmake move
+        if (stopped) return 0;
+        searched++;
+        
+        if (score > bestScore) {
+            bestScore = score; // new best
+            bestMove = move; // best move
+            if (score > alpha) {
+                alpha = score; // raise alpha
+                pvTable[ply][ply] = move; // prepend move to child line
+                for (int next = ply + 1; next < pvLength[ply + 1]; ++next) {
+                    pvTable[ply][next] = pvTable[ply + 1][next]; // copy child line
+                }
+                pvLength[ply] = pvLength[ply + 1]; // line length
+            }
+        }
+        if (alpha >= beta) { // beta cutoff
+            stats.cutoffs[stage]++; // count cutoff
+            if (searched == 1) stats.firstMoveCutoffs++; // ordering got it right first time
+            if (!move.isCapture() && !move.isPromotion()) {
+                updateQuietHeuristics(move, ply, depth, triedQuiets); // learn from quiet cutoff
+            }
+            break;
+        }
+        if (!move.isCapture() && !move.isPromotion()) {
+            triedQuiets.add(move); // quiet move that failed to cut
+        }
+    }
+    
+    Bound bound = (bestScore >= beta) ? Bound::LOWER : (bestScore > originalAlpha) ? Bound::EXACT : Bound::UPPER; // bound type
+    tt.store(key, depth, bound, scoreToTT(bestScore, ply), bestMove); // save result
+    return bestScore; // return best score
+}
+
+int SearchWorker::quiescence(int ply, int alpha, int beta) { // resolve captures and promotions before evaluating
+    pvLength[ply] = ply; // empty principal variation
+    
+    countNode(); // count node
+    if (stopped) return 0;
+    
+    int standPat = evaluate(); // score if the side to move stops capturing
+    if (ply >= MAX_PLY - 1) return standPat; // too deep
+    
+    Color side = board.getCurrentPlayer(); // side to move
+    bool inCheck = board.isInCheck(side); // every evasion must be searched
+    int bestScore = inCheck ? -INF_SCORE : standPat; // best score
+    if (!inCheck) {
+        if (standPat >= beta) return standPat; // stand pat cutoff
+        if (standPat > alpha) alpha = standPat; // raise alpha
+    }
+    
+    MovePicker picker(board, heuristics, PackedMove(), ply, PackedMove(), !inCheck); // captures only unless in check
+    if (inCheck && picker.legalMoveCount() == 0) {
+        return -MATE_SCORE + ply; // checkmate
+    }
+    
+    MoveUndo undo; // undo record
+    for (PackedMove move = picker.next(); !move.isNull(); move = picker.next()) {
+        if (!inCheck) {
+            if (!move.isPromotion()) {
+                const Piece* victim = board.getPiece(squareToPosition(move.to())); // captured piece
+                int victimValue = victim ? victim->getValue() : PAWN_VALUE; // en passant victim is a pawn
+                if (standPat + victimValue + DELTA_MARGIN <= alpha) continue; // delta pruning, cannot raise alpha
+            }
+        }
+        
+        board.makeMove(move, undo); // make move
+        int score = -quiescence(ply + 1, -beta, -alpha); // search child
+        board.unmakeMove(move, undo); // unmake move
+        if (stopped) return 0;
+        
+        if (score > bestScore) {
+            bestScore = score; // new best
+            if (score > alpha) {
+                alpha = score; // raise alpha
+                pvTable[ply][ply] = move; // prepend move to child line
+                for (int next = ply + 1; next < pvLength[ply + 1]; ++next) {
+                    pvTable[ply][next] = pvTable[ply + 1][next]; // copy child line
+                }
+                pvLength[ply] = pvLength[ply + 1]; // line length
+            }
+        }
+        if (alpha >= beta) break; // beta cutoff
+    }
+    return bestScore; // return best score
+}
+
+int SearchWorker::evaluate() { // static evaluation from the side to move's point of view
+    return Evaluation::evaluate(board, pawnTable); // board sums plus cached pawn structure
+}
+
+void SearchWorker::updateQuietHeuristics(PackedMove move, int ply, int depth, const MoveList& triedQuiets) { // reward a quiet cutoff move
+    Color side = board.getCurrentPlayer(); // side that made the move
+    int bonus = depth * depth; // deeper cutoffs count more
+    heuristics.addKiller(ply, move); // killer
+    heuristics.updateHistory(side, move, bonus); // history
+    for (PackedMove tried : triedQuiets) {
+        heuristics.updateHistory(side, tried, -bonus); // quiet moves searched first were worse
+    }
+    if (ply > 0 && !playedMoves[ply - 1].isNull()) {
+        PackedMove previous = playedMoves[ply - 1]; // move being refuted
+        heuristics.countermoves[previous.from()][previous.to()] = move; // countermove
+    }
+}
+
+void SearchWorker::countNode() { // count a node and poll the budget
+    if (++nodes % TimeManager::CHECK_INTERVAL != 0) return; // poll every few nodes
+    shared.nodes.fetch_add(nodes - publishedNodes, memory_order_relaxed); // publish batch
+    publishedNodes = nodes; // published
+    if (shared.stop.load(memory_order_relaxed)) {
+        stopped = true; // another thread ended the search
+    } else if (id == 0 && outOfBudget()) {
+        stopped = true; // budget exhausted
+        shared.stop.store(true, memory_order_relaxed); // end every thread
+    }
+}
+
+bool SearchWorker::outOfBudget() const { // time or node budget exhausted, checked by the main thread
+    const SearchLimits& limits = shared.limits; // budget
+    if (mustKeepSearching()) return false; // only stop ends an infinite or ponder search
+    if (limits.nodes > 0 && shared.nodes.load(memory_order_relaxed) >= limits.nodes) return true; // node budget
+    if (shared.timeManager.hardExpired()) return true; // time budget
+    return false;
+}
+
+bool SearchWorker::mustKeepSearching() const { // infinite or ponder search not yet released
+    return shared.limits.infinite || shared.pondering.load(memory_order_relaxed);
+}
+
+int scoreToTT(int score, int ply) { // make mate scores relative to the stored node
+    if (score >= MATE_SCORE - MAX_PLY) return score + ply; // mate for side to move
+    if (score <= -MATE_SCORE + MAX_PLY) return score - ply; // mated
+    return score;
+}
+
+int scoreFromTT(int score, int ply) { // make stored mate scores relative to the root
+    if (score >= MATE_SCORE - MAX_PLY) return score - ply; // mate for side to move
+    if (score <= -MATE_SCORE + MAX_PLY) return score + ply; // mated
+    return score;
+}
@@ -0,0 +1,120 @@
+#ifndef SEARCH_H
+#define SEARCH_H
+
+#include "Board.h"
+#include "MovePicker.h"
+#include "PawnTable.h"
+#include "TimeManager.h"
+#include "TranspositionTable.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+using namespace std;
+
+const int MATE_SCORE = 100000; // score of delivering mate at the root
+const int INF_SCORE = 1000000; // bound larger than any score
+const int DELTA_MARGIN = 200; // slack added to a capture's gain before delta pruning it
+const int MAX_THREADS = 256; // most search threads accepted
+
+struct SearchLimits { // search budget
+    int maxDepth = MAX_PLY - 1; // deepest iteration
+    TimeControl time; // clock, none by default
+    uint64_t nodes = 0; // node budget over all threads, 0 for none
+    int threads = 1; // search threads
+    bool infinite = false; // search until stopped, ignoring the time control
+    bool ponder = false; // search the expected reply until a ponder hit or stop
+};
+
+struct SearchResult { // outcome of a search
+    Move bestMove; // best move found
+    int score = 0; // score from the side to move's point of view
+    int depth = 0; // last completed iteration
+    uint64_t nodes = 0; // nodes visited by every thread
+    int threads = 1; // threads that searched
+    int64_t timeMs = 0; // milliseconds since the search started
+    vector<PackedMove> pv; // principal variation
+};
+
+using SearchProgress = function<void(const SearchResult&)>; // called by the main thread after each iteration
+
+struct alignas(64) SearchShared { // state every thread of one search reads, on its own cache line
+    SearchLimits limits; // budget
+    TimeManager timeManager; // deadlines, read and adjusted only by the main thread
+    SearchProgress progress; // iteration report, may be empty
+    atomic<bool> stop{false}; // set once the search must end
+    atomic<bool> pondering{false}; // deadlines are ignored until a ponder hit
+    atomic<uint64_t> nodes{0}; // nodes of every thread, published in batches
+};
+
+// one lazy smp thread: a full iterative deepening search of its own board copy.
+// threads only talk through the shared transposition table and stop flag, and
+// helpers skip some depths so they fill the table ahead of the main thread.
+// aligned so no two threads' node counters and stacks share a cache line
+class alignas(64) SearchWorker {
+    Board board; // private copy searched in place with makeMove/unmakeMove
+    TranspositionTable& tt; // shared transposition table
+    PawnTable& pawnTable; // pawn structure cache of this thread
+    SearchShared& shared; // limits and stop flag
+    int id; // thread number, 0 is the main thread
+    uint64_t nodes; // nodes visited
+    uint64_t publishedNodes; // nodes already added to the shared count
+    bool stopped; // search ended
+    MoveHistory heuristics; // killers, history and countermoves
+    OrderingStats stats; // move ordering counters
+    array<array<PackedMove, MAX_PLY>, MAX_PLY> pvTable; // triangular principal variation table
+    array<int, MAX_PLY> pvLength; // principal variation length per ply
+    array<PackedMove, MAX_PLY> playedMoves; // move made at each ply of the current line
+    PackedMove rootPvMove; // best move of the previous iteration
+    SearchResult result; // last completed iteration
+    
+    int negamax(int depth, int ply, int alpha, int beta); // search a node
+    int quiescence(int ply, int alpha, int beta); // resolve captures and promotions before evaluating
+    int evaluate(); // static evaluation from the side to move's point of view
+    void updateQuietHeuristics(PackedMove move, int ply, int depth, const MoveList& triedQuiets); // reward a quiet cutoff move
+    bool skipsDepth(int depth) const; // helper threads leave out some depths
+    void countNode(); // count a node and poll the budget
+    bool outOfBudget() const; // time or node budget exhausted, checked by the main thread
+    bool mustKeepSearching() const; // infinite or ponder search not yet released
+    
+public:
+    SearchWorker(const Board& board, TranspositionTable& tt, PawnTable& pawnTable, SearchShared& shared, const MoveHistory& heuristics, int id); // constructor
+    
+    void iterate(); // run iterative deepening until the depth limit or the stop flag
+    const SearchResult& getResult() const { return result; } // last completed iteration
+    uint64_t getNodes() const { return nodes; } // nodes visited
+    const MoveHistory& getHeuristics() const { return heuristics; } // learned move ordering
+    const OrderingStats& getOrderingStats() const { return stats; } // move ordering counters
+};
+
+// lazy smp search driver: starts the workers, waits for the main one and
+// reports the deepest completed result. stop and ponderHit may be called from
+// another thread while think runs
+class Search {
+    const Board& board; // position to search, left untouched
+    TranspositionTable& tt; // shared transposition table
+    PawnTables& pawnTables; // pawn structure caches, one per thread
+    MoveHistory& heuristics; // move ordering kept between searches
+    pmr::memory_resource* memory; // where the workers are allocated
+    OrderingStats stats; // move ordering counters of every thread
+    SearchShared shared; // state shared by the threads
+    
+public:
+    Search(const Board& board, TranspositionTable& tt, PawnTables& pawnTables, MoveHistory& heuristics,
+           pmr::memory_resource* memory = pmr::get_default_resource()); // constructor
+    
+    SearchResult think(const SearchLimits& searchLimits); // run iterative deepening on every thread
+    void setProgressCallback(SearchProgress callback) { shared.progress = move(callback); } // report each iteration
+    void stop() { shared.stop.store(true, memory_order_relaxed); } // end the search, keeping the best move so far
+    void ponderHit() { shared.pondering.store(false, memory_order_relaxed); } // the expected move was played, deadlines counted from the start now apply
+    const OrderingStats& getOrderingStats() const { return stats; } // move ordering counters
+};
+
+int scoreToTT(int score, int ply); // make mate scores relative to the stored node
+int scoreFromTT(int score, int ply); // make stored mate scores relative to the root
+
+#endif
@@ -0,0 +1,124 @@
+#include "Stats.h"
+#include <atomic>
+#include <cstdlib>
+#include <iomanip>
+#include <new>
+
+using namespace std;
+
+#ifdef CHESS_STATS
+
+struct SectionCounters { // counters of one section
+    atomic<uint64_t> calls{0}; // calls
+    atomic<uint64_t> nanoseconds{0}; // time inside
+};
+
+static SectionCounters sections[STAT_COUNT]; // counters per section
+static atomic<uint64_t> moves{0}; // moves played
+static atomic<uint64_t> allocations{0}; // operator new calls
+static atomic<uint64_t> allocatedBytes{0}; // bytes requested from operator new
+static atomic<uint64_t> frees{0}; // operator delete calls
+
+static const char* SECTION_NAMES[STAT_COUNT] = {
+    "legal moves", "board copy", "square attacked", "notify", "text display", "graphical display"
+};
+
+// every allocation in the program goes through these, so counting here covers
+// containers, strings and piece objects alike
+void* operator new(size_t size) {
+    allocations.fetch_add(1, memory_order_relaxed);
+    allocatedBytes.fetch_add(size, memory_order_relaxed);
+    if (void* memory = malloc(size ? size : 1)) return memory;
+    throw bad_alloc();
+}
+
+void* operator new(size_t size, align_val_t alignment) {
+    allocations.fetch_add(1, memory_order_relaxed);
+    allocatedBytes.fetch_add(size, memory_order_relaxed);
+    size_t align = static_cast<size_t>(alignment); // alignment
+    if (void* memory = aligned_alloc(align, (size + align - 1) / align * align)) return memory; // size must be a multiple
+    throw bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+    if (memory) frees.fetch_add(1, memory_order_relaxed);
+    free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept {
+    operator delete(memory);
+}
+
+void operator delete(void* memory, align_val_t) noexcept {
+    operator delete(memory);
+}
+
+void operator delete(void* memory, size_t, align_val_t) noexcept {
+    operator delete(memory);
+}
+
+bool Stats::enabled() { // counters are compiled in
+    return true;
+}
+
+// count one call of a section
+void Stats::record(StatId id, uint64_t nanoseconds) {
+    SectionCounters& section = sections[static_cast<int>(id)]; // section
+    section.calls.fetch_add(1, memory_order_relaxed);
+    section.nanoseconds.fetch_add(nanoseconds, memory_order_relaxed);
+}
+
+// a move was played on a board
+void Stats::countMove() {
+    moves.fetch_add(1, memory_order_relaxed);
+}
+
+// zero every counter
+void Stats::clear() {
+    for (SectionCounters& section : sections) {
+        section.calls.store(0, memory_order_relaxed);
+        section.nanoseconds.store(0, memory_order_relaxed);
+    }
+    moves.store(0, memory_order_relaxed);
+    allocations.store(0, memory_order_relaxed);
+    allocatedBytes.store(0, memory_order_relaxed);
+    frees.store(0, memory_order_relaxed);
+}
+
+// print counters per section, per move and for allocations
+void Stats::print(ostream& out) {
+    uint64_t moveCount = moves.load(memory_order_relaxed); // moves played
+    double perMove = moveCount ? 1.0 / moveCount : 0.0; // scale to one move
+    out << "Moves: " << moveCount << "\n";
+    out << left << setw(20) << "Section" << right << setw(12) << "Calls" << setw(12) << "Total ms"
+        << setw(10) << "ns/call" << setw(12) << "Calls/move" << setw(10) << "ms/move" << "\n";
+    for (int i = 0; i < STAT_COUNT; ++i) {
+        uint64_t calls = sections[i].calls.load(memory_order_relaxed); // calls
+        double ms = sections[i].nanoseconds.load(memory_order_relaxed) / 1e6; // time inside
+        out << left << setw(20) << SECTION_NAMES[i] << right << setw(12) << calls << setw(12) << fixed << setprecision(2) << ms
+            << setw(10) << setprecision(0) << (calls ? ms * 1e6 / calls : 0.0)
+            << setw(12) << setprecision(1) << calls * perMove << setw(10) << setprecision(2) << ms * perMove << "\n";
+    }
+    uint64_t count = allocations.load(memory_order_relaxed); // allocations
+    out << "Allocations: " << count << " (" << allocatedBytes.load(memory_order_relaxed) << " bytes), "
+        << frees.load(memory_order_relaxed) << " frees, " << fixed << setprecision(1) << count * perMove << " per move\n";
+    out.unsetf(ios::floatfield); // restore default formatting
+    out << setprecision(6);
+}
+
+#else
+
+bool Stats::enabled() { // counters are compiled in
+    return false;
+}
+
+void Stats::record(StatId, uint64_t) {} // count one call of a section
+void Stats::countMove() {} // a move was played on a board
+void Stats::clear() {} // zero every counter
+
+// print counters per section, per move and for allocations
+void Stats::print(ostream& out) {
+    out << "Statistics are not compiled in, rebuild with make STATS=1\n";
+}
+
+#endif
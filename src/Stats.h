@@ -0,0 +1,53 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+using namespace std;
+
+enum class StatId { // instrumented sections
+    LEGAL_MOVES, // Board::getAllLegalMoves
+    BOARD_COPY, // Board::createCopy
+    SQUARE_ATTACKED, // Board::isSquareAttacked
+    NOTIFY_OBSERVERS, // Board::notifyObservers
+    TEXT_DISPLAY, // TextDisplay::displayBoard
+    GRAPHICAL_DISPLAY // GraphicalDisplay::renderBoard
+};
+
+const int STAT_COUNT = 6; // number of instrumented sections
+
+// call counters, scoped timers and a global allocation counter for finding
+// where time goes per move without an external profiler. everything is
+// compiled in only when CHESS_STATS is defined (make STATS=1); otherwise the
+// macros expand to nothing and print reports that statistics are off
+class Stats {
+public:
+    static bool enabled(); // counters are compiled in
+    static void record(StatId id, uint64_t nanoseconds); // count one call of a section
+    static void countMove(); // a move was played on a board
+    static void clear(); // zero every counter
+    static void print(ostream& out); // print counters per section, per move and for allocations
+};
+
+#ifdef CHESS_STATS
+class ScopedTimer { // times its scope into a section
+    StatId id; // section
+    chrono::steady_clock::time_point start; // entry time
+
+public:
+    explicit ScopedTimer(StatId id) : id(id), start(chrono::steady_clock::now()) {} // constructor
+    ~ScopedTimer() { // destructor
+        Stats::record(id, chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count());
+    }
+};
+
+#define STATS_SCOPE(id) ScopedTimer statsScope(id)
+#define STATS_COUNT_MOVE() Stats::countMove()
+#else
+#define STATS_SCOPE(id) ((void)0)
+#define STATS_COUNT_MOVE() ((void)0)
+#endif
+
+#endif
@@ -1,4 +1,5 @@
 #include "TextDisplay.h"
+#include "Stats.h"
 #include <iostream>
 #include <iomanip>
 #include <cctype>
@@ -11,6 +12,7 @@ TextDisplay::TextDisplay(ostream& out, bool coords, bool unicode, bool assignmen
 }
 
 void TextDisplay::displayBoard(const Board& board) {
+    STATS_SCOPE(StatId::TEXT_DISPLAY);
     if (assignmentStyle) {
         drawAssignmentBoard(board);
     } else {
@@ -0,0 +1,63 @@
+#include "TimeManager.h"
+#include <algorithm>
+
+using namespace std;
+
+// constructor
+TimeManager::TimeManager() : startTime(chrono::steady_clock::now()), optimumMs(0), softMs(0), hardMs(0), limited(false), instability(0.0) {
+}
+
+// plan the deadlines for a move
+void TimeManager::start(const TimeControl& control) {
+    startTime = chrono::steady_clock::now(); // start time
+    instability = 0.0; // no iterations yet
+    limited = control.isLimited(); // has deadlines
+    
+    if (control.moveTimeMs > 0) { // fixed time per move
+        optimumMs = max<int64_t>(1, control.moveTimeMs - MOVE_OVERHEAD_MS); // use all of it
+        hardMs = optimumMs; // no extension past the fixed time
+        updateSoftDeadline(); // soft deadline
+        return;
+    }
+    if (control.remainingMs <= 0) { // no clock
+        optimumMs = softMs = hardMs = 0;
+        return;
+    }
+    
+    int64_t available = max<int64_t>(1, control.remainingMs - MOVE_OVERHEAD_MS); // time that can be spent
+    int movesLeft = control.movesToGo > 0 ? min(control.movesToGo, 50) : 30; // moves to share the clock between
+    optimumMs = available / movesLeft + control.incrementMs * 3 / 4; // even share plus most of the increment
+    optimumMs = clamp<int64_t>(optimumMs, 1, available); // never plan past the flag
+    
+    int64_t hardCap = control.movesToGo == 1 ? available : available / 4; // never burn most of the clock on one move
+    hardMs = clamp<int64_t>(optimumMs * 5, 1, max<int64_t>(1, hardCap)); // room for extensions
+    updateSoftDeadline(); // soft deadline
+}
+
+// adjust the soft deadline after an iteration
+void TimeManager::iterationCompleted(bool bestMoveChanged) {
+    instability *= 0.5; // older changes count less
+    if (bestMoveChanged) instability += 1.0; // think longer while the best move is unsettled
+    updateSoftDeadline(); // soft deadline
+}
+
+// soft deadline from the optimum and the instability
+void TimeManager::updateSoftDeadline() {
+    int64_t planned = static_cast<int64_t>(optimumMs * (1.0 + instability)); // time for this move
+    softMs = min(hardMs, planned / 2); // the next iteration would not finish after this
+}
+
+// milliseconds since the move started
+int64_t TimeManager::elapsedMs() const {
+    return chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - startTime).count();
+}
+
+// should not start another iteration
+bool TimeManager::softExpired() const {
+    return limited && elapsedMs() >= softMs;
+}
+
+// must stop now
+bool TimeManager::hardExpired() const {
+    return limited && elapsedMs() >= hardMs;
+}
@@ -0,0 +1,50 @@
+#ifndef TIMEMANAGER_H
+#define TIMEMANAGER_H
+
+#include <chrono>
+#include <cstdint>
+
+using namespace std;
+
+struct TimeControl { // clock state handed to the search for one move
+    int64_t moveTimeMs = 0; // fixed time for this move, 0 to use the clock
+    int64_t remainingMs = 0; // time left on the clock, 0 for no clock
+    int64_t incrementMs = 0; // time added after each move
+    int movesToGo = 0; // moves until the next time control, 0 for sudden death
+    
+    bool isLimited() const { return moveTimeMs > 0 || remainingMs > 0; } // search has a deadline
+};
+
+// turns a clock into per-move deadlines. the soft deadline is when the search
+// should not start another iteration, since the next one usually takes at
+// least as long as all before it. the hard deadline is when it must stop in
+// the middle of one. the soft deadline grows while the best move keeps
+// changing between iterations and shrinks back once it settles.
+class TimeManager {
+    chrono::steady_clock::time_point startTime; // when the move started
+    int64_t optimumMs; // planned time for a settled best move
+    int64_t softMs; // do not start another iteration after this
+    int64_t hardMs; // abort the iteration after this
+    bool limited; // has deadlines at all
+    double instability; // how often the best move changed recently
+    
+    void updateSoftDeadline(); // soft deadline from the optimum and the instability
+    
+public:
+    static constexpr int64_t MOVE_OVERHEAD_MS = 20; // kept back for output and move handling
+    static constexpr int CHECK_INTERVAL = 1024; // nodes between deadline checks
+    
+    TimeManager(); // constructor
+    
+    void start(const TimeControl& control); // plan the deadlines for a move
+    void iterationCompleted(bool bestMoveChanged); // adjust the soft deadline after an iteration
+    
+    int64_t elapsedMs() const; // milliseconds since the move started
+    bool isLimited() const { return limited; } // has deadlines
+    bool softExpired() const; // should not start another iteration
+    bool hardExpired() const; // must stop now
+    int64_t getSoftMs() const { return softMs; } // soft deadline
+    int64_t getHardMs() const { return hardMs; } // hard deadline
+};
+
+#endif
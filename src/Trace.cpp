@@ -0,0 +1,161 @@
+#include "Trace.h"
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+
+using namespace std;
+
+struct TraceEvent { // one complete event
+    const char* name; // event name
+    const char* argName; // name of the extra value, nullptr for none
+    int64_t arg; // extra value
+    int64_t start; // entry time in nanoseconds
+    int64_t end; // exit time in nanoseconds
+};
+
+struct TraceChunk { // fixed block of events, filled by one thread
+    static constexpr size_t SIZE = 1024; // events per chunk
+    TraceEvent events[SIZE]; // events
+    atomic<size_t> count{0}; // events published to the reader
+    atomic<TraceChunk*> next{nullptr}; // chunk filled after this one
+};
+
+// events of one thread. only the owning thread writes chunks and only the
+// reader in stop frees them, so publishing an event is a release store of the
+// chunk count. a buffer outlives its thread and is taken over by the next
+// thread with the same name, so the search threads started for every move
+// keep one track each instead of piling up new ones
+struct TraceBuffer {
+    int tid; // track id
+    const char* name; // track label, nullptr for unnamed threads
+    int index; // number shown after the label, -1 for none
+    atomic<bool> inUse{true}; // owned by a running thread
+    atomic<TraceChunk*> first{nullptr}; // oldest chunk, set once by the owner
+    TraceChunk* tail = nullptr; // chunk being filled, owner only
+    TraceChunk* readChunk = nullptr; // chunk the reader is in, reader only
+    size_t readIndex = 0; // events of readChunk already read, reader only
+    TraceBuffer* next = nullptr; // next buffer in the registry, fixed once published
+};
+
+static const chrono::steady_clock::time_point epoch = chrono::steady_clock::now(); // trace clock origin
+static atomic<TraceBuffer*> buffers{nullptr}; // every buffer ever made, newest first
+static atomic<int> nextTid{1}; // track id of the next new buffer
+static ofstream output; // file of the current recording
+static string filename; // its name
+static int64_t sessionStart = 0; // events before this belong to an earlier recording
+
+// a thread's claim on its buffer, handed back when the thread ends
+struct BufferHandle {
+    TraceBuffer* buffer = nullptr; // claimed buffer
+
+    ~BufferHandle() { // destructor
+        if (buffer) buffer->inUse.store(false, memory_order_release);
+    }
+};
+
+static thread_local BufferHandle handle; // this thread's claim
+
+// idle buffer with this label, or a new one
+static TraceBuffer* claimBuffer(const char* name, int index) {
+    for (TraceBuffer* buffer = buffers.load(memory_order_acquire); buffer; buffer = buffer->next) {
+        bool sameName = (buffer->name && name) ? strcmp(buffer->name, name) == 0 : buffer->name == name; // same label
+        bool idle = false; // expected state
+        if (sameName && buffer->index == index && buffer->inUse.compare_exchange_strong(idle, true, memory_order_acq_rel)) {
+            return buffer; // left by a finished thread
+        }
+    }
+
+    TraceBuffer* buffer = new TraceBuffer(); // new track, kept for the rest of the program
+    buffer->tid = nextTid.fetch_add(1, memory_order_relaxed);
+    buffer->name = name;
+    buffer->index = index;
+    buffer->next = buffers.load(memory_order_relaxed);
+    while (!buffers.compare_exchange_weak(buffer->next, buffer, memory_order_release, memory_order_relaxed)) {}
+    return buffer;
+}
+
+// nanoseconds on the trace clock
+int64_t Trace::now() {
+    return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - epoch).count();
+}
+
+// label the calling thread's track
+void Trace::setThreadName(const char* name, int index) {
+    if (handle.buffer) handle.buffer->inUse.store(false, memory_order_release); // move to the track with this label
+    handle.buffer = claimBuffer(name, index);
+}
+
+// append an event to the calling thread's buffer
+void Trace::record(const char* name, int64_t start, int64_t end, const char* argName, int64_t arg) {
+    if (!handle.buffer) handle.buffer = claimBuffer(nullptr, -1); // thread without a label
+    TraceBuffer* buffer = handle.buffer; // calling thread's buffer
+    TraceChunk* chunk = buffer->tail; // chunk being filled
+    size_t count = chunk ? chunk->count.load(memory_order_relaxed) : TraceChunk::SIZE; // events in it
+    if (count == TraceChunk::SIZE) { // no chunk yet or it is full
+        TraceChunk* fresh = new TraceChunk(); // next chunk
+        if (chunk) chunk->next.store(fresh, memory_order_release);
+        else buffer->first.store(fresh, memory_order_release);
+        buffer->tail = chunk = fresh;
+        count = 0;
+    }
+    chunk->events[count] = TraceEvent{name, argName, arg, start, end};
+    chunk->count.store(count + 1, memory_order_release); // publish
+}
+
+// begin recording into a file, false if it cannot be opened
+bool Trace::start(const string& file) {
+    if (isRecording()) stop(); // finish the previous file
+    output.open(file);
+    if (!output) {
+        output.clear();
+        return false; // cannot write there
+    }
+    filename = file;
+    sessionStart = now();
+    output << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    output << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"chess\"}}";
+    recording.store(true, memory_order_relaxed);
+    return true;
+}
+
+// write the events recorded since start, false if not recording
+bool Trace::stop() {
+    if (!isRecording()) return false;
+    recording.store(false, memory_order_relaxed); // scopes entered from now on are not recorded
+
+    output << fixed << setprecision(3); // microseconds with nanosecond digits
+    for (TraceBuffer* buffer = buffers.load(memory_order_acquire); buffer; buffer = buffer->next) {
+        if (buffer->name) { // track label
+            output << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->tid << ",\"args\":{\"name\":\"" << buffer->name;
+            if (buffer->index >= 0) output << " " << buffer->index;
+            output << "\"}}";
+        }
+
+        if (!buffer->readChunk) buffer->readChunk = buffer->first.load(memory_order_acquire); // first events of this track
+        while (TraceChunk* chunk = buffer->readChunk) {
+            size_t count = chunk->count.load(memory_order_acquire); // published events
+            for (; buffer->readIndex < count; ++buffer->readIndex) {
+                const TraceEvent& event = chunk->events[buffer->readIndex]; // event
+                if (event.start < sessionStart) continue; // scope entered during an earlier recording
+                output << ",\n{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->tid
+                       << ",\"ts\":" << event.start / 1000.0 << ",\"dur\":" << (event.end - event.start) / 1000.0;
+                if (event.argName) output << ",\"args\":{\"" << event.argName << "\":" << event.arg << "}";
+                output << "}";
+            }
+            TraceChunk* next = chunk->next.load(memory_order_acquire); // chunk filled after this one
+            if (count < TraceChunk::SIZE || !next) break; // the owner may still be filling this one
+            buffer->readChunk = next; // the owner has moved on, so nobody touches this chunk again
+            buffer->readIndex = 0;
+            delete chunk;
+        }
+    }
+    output << "\n]}\n";
+    output.close();
+    return true;
+}
+
+// file of the current recording
+const string& Trace::getFilename() {
+    return filename;
+}
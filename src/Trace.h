@@ -0,0 +1,45 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+using namespace std;
+
+// records timed scopes as Chrome trace events (load the file in Perfetto or
+// chrome://tracing), one track per thread. each thread appends to its own
+// chunked buffer, so recording takes no lock and costs one relaxed load when
+// tracing is off. stop collects every buffer and writes the JSON file
+class Trace {
+    static inline atomic<bool> recording{false}; // scopes are being recorded
+
+public:
+    static bool start(const string& filename); // begin recording into a file, false if it cannot be opened
+    static bool stop(); // write the events recorded since start, false if not recording
+    static bool isRecording() { return recording.load(memory_order_relaxed); } // scopes are being recorded
+    static const string& getFilename(); // file of the current recording
+    static void setThreadName(const char* name, int index = -1); // label the calling thread's track
+    static int64_t now(); // nanoseconds on the trace clock
+    static void record(const char* name, int64_t start, int64_t end, const char* argName, int64_t arg); // append an event to the calling thread's buffer
+};
+
+class TraceScope { // records its scope as one event on the calling thread's track
+    const char* name; // event name, a string literal
+    const char* argName; // name of the extra value, nullptr for none
+    int64_t arg; // extra value shown with the event
+    int64_t start; // entry time, -1 when not recording
+
+public:
+    explicit TraceScope(const char* name, const char* argName = nullptr, int64_t arg = 0)
+        : name(name), argName(argName), arg(arg), start(Trace::isRecording() ? Trace::now() : -1) {} // constructor
+    ~TraceScope() { // destructor
+        if (start >= 0) Trace::record(name, start, Trace::now(), argName, arg);
+    }
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+};
+
+#define TRACE_SCOPE(...) TraceScope traceScope(__VA_ARGS__)
+
+#endif
@@ -0,0 +1,125 @@
+#include "TranspositionTable.h"
+#include <algorithm>
+#include <bit>
+
+using namespace std;
+
+// constructor
+TranspositionTable::TranspositionTable(size_t mb) : entryCount(0), sizeMB(0), age(0) {
+    resize(mb); // allocate
+}
+
+// reallocate, must not be called while searching
+void TranspositionTable::resize(size_t mb) {
+    mb = clamp<size_t>(mb, 1, MAX_SIZE_MB); // keep size sensible
+    size_t count = bit_floor((mb << 20) / sizeof(Entry)); // largest power of two that fits
+    entries = make_unique<Entry[]>(count); // value-initialised, so every slot starts empty
+    entryCount = count; // slots
+    sizeMB = mb; // size
+    age = 0; // restart generations
+    resetStats(); // reset counters
+}
+
+// empty every slot and reset counters
+void TranspositionTable::clear() {
+    for (size_t i = 0; i < entryCount; ++i) {
+        entries[i].check.store(0, memory_order_relaxed); // clear key
+        entries[i].data.store(0, memory_order_relaxed); // clear data
+    }
+    age = 0; // restart generations
+    resetStats(); // reset counters
+}
+
+// advance the age so older entries are replaced first
+void TranspositionTable::newSearch() {
+    age = (age + 1) & 63; // six bit generation
+}
+
+// look up a position
+bool TranspositionTable::probe(uint64_t key, TTProbe& result) {
+    Entry& entry = entries[key & (entryCount - 1)]; // slot
+    uint64_t data = entry.data.load(memory_order_relaxed); // data
+    uint64_t check = entry.check.load(memory_order_relaxed); // key xor data
+    
+    if (boundOf(data) == Bound::NONE) { // empty slot
+        localShard().misses.fetch_add(1, memory_order_relaxed);
+        return false;
+    }
+    if ((check ^ data) != key) { // another position, or a torn write
+        localShard().collisions.fetch_add(1, memory_order_relaxed);
+        return false;
+    }
+    
+    localShard().hits.fetch_add(1, memory_order_relaxed);
+    result.move = PackedMove::fromRaw(static_cast<uint16_t>(data & 0xFFFF)); // move
+    result.score = static_cast<int32_t>(static_cast<uint32_t>(data >> 16)); // score
+    result.depth = depthOf(data); // depth
+    result.bound = boundOf(data); // bound
+    return true;
+}
+
+// save a search result
+void TranspositionTable::store(uint64_t key, int depth, Bound bound, int score, PackedMove move) {
+    Entry& entry = entries[key & (entryCount - 1)]; // slot
+    uint64_t oldData = entry.data.load(memory_order_relaxed); // current data
+    uint64_t oldKey = entry.check.load(memory_order_relaxed) ^ oldData; // current key
+    bool occupied = boundOf(oldData) != Bound::NONE; // slot in use
+    
+    if (occupied && oldKey == key) { // same position
+        if (move.isNull()) move = PackedMove::fromRaw(static_cast<uint16_t>(oldData & 0xFFFF)); // keep the known best move
+        if (bound != Bound::EXACT && depthOf(oldData) > depth + 2) return; // keep the much deeper result
+    } else if (occupied && ageOf(oldData) == age && depthOf(oldData) > depth) {
+        return; // keep the deeper result from this search
+    }
+    
+    uint64_t data = pack(move, score, depth, bound, age); // new data
+    entry.check.store(key ^ data, memory_order_relaxed); // verification word
+    entry.data.store(data, memory_order_relaxed); // data
+    localShard().stores.fetch_add(1, memory_order_relaxed);
+}
+
+// pack entry data
+uint64_t TranspositionTable::pack(PackedMove move, int score, int depth, Bound bound, uint8_t age) {
+    return static_cast<uint64_t>(move.raw()) // bits 0-15
+         | static_cast<uint64_t>(static_cast<uint32_t>(score)) << 16 // bits 16-47
+         | static_cast<uint64_t>(clamp(depth, 0, 255)) << 48 // bits 48-55
+         | static_cast<uint64_t>(bound) << 56 // bits 56-57
+         | static_cast<uint64_t>(age & 63) << 58; // bits 58-63
+}
+
+// permille of sampled slots written by the current search
+int TranspositionTable::hashfull() const {
+    size_t sample = min<size_t>(1000, entryCount); // sample size
+    int used = 0; // slots in use
+    for (size_t i = 0; i < sample; ++i) {
+        uint64_t data = entries[i].data.load(memory_order_relaxed); // data
+        if (boundOf(data) != Bound::NONE && ageOf(data) == age) ++used; // written this search
+    }
+    return static_cast<int>(used * 1000 / sample); // permille
+}
+
+// zero the counters
+void TranspositionTable::resetStats() {
+    for (StatShard& shard : shards) {
+        shard.hits.store(0, memory_order_relaxed);
+        shard.misses.store(0, memory_order_relaxed);
+        shard.collisions.store(0, memory_order_relaxed);
+        shard.stores.store(0, memory_order_relaxed);
+    }
+}
+
+// counter shard of the calling thread
+TranspositionTable::StatShard& TranspositionTable::localShard() {
+    static atomic<unsigned> nextShard{0}; // shard handed to the next new thread
+    thread_local unsigned shard = nextShard.fetch_add(1, memory_order_relaxed) % STAT_SHARDS; // this thread's shard
+    return shards[shard];
+}
+
+// total of a counter over every shard
+uint64_t TranspositionTable::sum(atomic<uint64_t> StatShard::*counter) const {
+    uint64_t total = 0; // total
+    for (const StatShard& shard : shards) {
+        total += (shard.*counter).load(memory_order_relaxed);
+    }
+    return total;
+}
@@ -0,0 +1,83 @@
+#ifndef TRANSPOSITIONTABLE_H
+#define TRANSPOSITIONTABLE_H
+
+#include "MoveList.h"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+using namespace std;
+
+enum class Bound : uint8_t { // how a stored score relates to the true score
+    NONE,
+    UPPER,
+    LOWER,
+    EXACT
+};
+
+struct TTProbe { // decoded table entry
+    int depth = 0; // search depth of the stored result
+    Bound bound = Bound::NONE; // bound type
+    int score = 0; // stored score
+    PackedMove move; // best move
+};
+
+// fixed-size lock-free transposition table shared between search threads.
+// each slot stores the key xor-ed with its data, so a slot torn by two
+// concurrent writers fails verification instead of returning wrong data.
+// counters are split into cache line sized shards, one per thread, so
+// probing threads never bounce a shared counter line between cores.
+class TranspositionTable {
+    struct Entry { // table slot
+        atomic<uint64_t> check; // zobrist key xor data
+        atomic<uint64_t> data; // packed move, score, depth, bound and age
+    };
+    
+    struct alignas(64) StatShard { // counters written by one thread
+        atomic<uint64_t> hits{0}; // probes that found the position
+        atomic<uint64_t> misses{0}; // probes that found an empty slot
+        atomic<uint64_t> collisions{0}; // probes that found another position
+        atomic<uint64_t> stores{0}; // entries written
+    };
+    
+    static constexpr int STAT_SHARDS = 64; // counter shards, threads beyond this share
+    
+    unique_ptr<Entry[]> entries; // slots
+    size_t entryCount; // number of slots, a power of two
+    size_t sizeMB; // requested size in megabytes
+    uint8_t age; // generation of the current search
+    array<StatShard, STAT_SHARDS> shards; // counters
+    
+    StatShard& localShard(); // counter shard of the calling thread
+    uint64_t sum(atomic<uint64_t> StatShard::*counter) const; // total of a counter over every shard
+    static uint64_t pack(PackedMove move, int score, int depth, Bound bound, uint8_t age); // pack entry data
+    static Bound boundOf(uint64_t data) { return static_cast<Bound>((data >> 56) & 3); } // bound of packed data
+    static int depthOf(uint64_t data) { return static_cast<int>((data >> 48) & 0xFF); } // depth of packed data
+    static uint8_t ageOf(uint64_t data) { return static_cast<uint8_t>(data >> 58); } // age of packed data
+    
+public:
+    static constexpr size_t DEFAULT_SIZE_MB = 16; // default table size
+    static constexpr size_t MAX_SIZE_MB = 4096; // largest accepted table size
+    
+    TranspositionTable(size_t mb = DEFAULT_SIZE_MB); // constructor
+    
+    void resize(size_t mb); // reallocate, must not be called while searching
+    void clear(); // empty every slot and reset counters
+    void newSearch(); // advance the age so older entries are replaced first
+    
+    bool probe(uint64_t key, TTProbe& result); // look up a position
+    void store(uint64_t key, int depth, Bound bound, int score, PackedMove move); // save a search result
+    
+    size_t getSizeMB() const { return sizeMB; } // get size in megabytes
+    size_t getEntryCount() const { return entryCount; } // get number of slots
+    int hashfull() const; // permille of sampled slots written by the current search
+    uint64_t getHits() const { return sum(&StatShard::hits); } // get hits
+    uint64_t getMisses() const { return sum(&StatShard::misses); } // get misses
+    uint64_t getCollisions() const { return sum(&StatShard::collisions); } // get collisions
+    uint64_t getStores() const { return sum(&StatShard::stores); } // get stores
+    void resetStats(); // zero the counters
+};
+
+#endif
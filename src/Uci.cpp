@@ -0,0 +1,215 @@
+#include "Uci.h"
+#include <algorithm>
+
+using namespace std;
+
+const string Uci::START_FEN = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+// constructor
+Uci::Uci(istream& in, ostream& out) : in(in), out(out), threads(1), infinite(false), pondering(false) {
+    board.loadFromFEN(START_FEN); // start position
+}
+
+// destructor, stops any running search
+Uci::~Uci() {
+    search.stop(); // end the search
+    waitForSearch(); // wait for it
+}
+
+// process commands until quit or end of input
+void Uci::loop() {
+    string line; // command line
+    while (getline(in, line)) {
+        istringstream args(line); // arguments
+        string command; // command
+        args >> command;
+        
+        if (command == "uci") {
+            handleUci(); // identify
+        } else if (command == "isready") {
+            send("readyok"); // ready
+        } else if (command == "setoption") {
+            waitForSearch(); // options never change under a running search
+            handleSetOption(args); // change option
+        } else if (command == "ucinewgame") {
+            waitForSearch(); // finish any search
+            tt.clear(); // forget the old game
+            pawnTables.clear();
+            heuristics.clear();
+        } else if (command == "position") {
+            waitForSearch(); // finish any search
+            handlePosition(args); // set position
+        } else if (command == "go") {
+            waitForSearch(); // finish any search
+            handleGo(args); // start search
+        } else if (command == "stop") {
+            search.stop(); // best move so far
+            waitForSearch(); // bestmove is sent before returning
+        } else if (command == "ponderhit") {
+            pondering = false; // its limits apply from here
+            search.ponderHit(); // switch to the time control
+        } else if (command == "quit") {
+            return; // destructor stops the search
+        }
+        // unknown commands are ignored, as the protocol asks
+    }
+    
+    // input ended without quit, as when commands are piped in. a search with
+    // limits still finishes and answers; one waiting for stop is ended by the destructor
+    if (!infinite && !pondering) waitForSearch();
+}
+
+// write one line
+void Uci::send(const string& line) {
+    lock_guard<mutex> lock(outMutex); // one writer at a time
+    out << line << endl;
+}
+
+// identify and list options
+void Uci::handleUci() {
+    send("id name Chess");
+    send("id author Chess contributors");
+    send("option name Hash type spin default " + to_string(TranspositionTable::DEFAULT_SIZE_MB) + " min 1 max " + to_string(TranspositionTable::MAX_SIZE_MB));
+    send("option name Pawn Hash type spin default " + to_string(PawnTable::DEFAULT_SIZE_KB) + " min 1 max " + to_string(PawnTable::MAX_SIZE_KB));
+    send("option name Threads type spin default 1 min 1 max " + to_string(MAX_THREADS));
+    send("option name Ponder type check default false");
+    send("option name Clear Hash type button");
+    send("uciok");
+}
+
+// change an option
+void Uci::handleSetOption(istringstream& args) {
+    string token, name, value; // option name and value, names may contain spaces
+    args >> token; // "name"
+    while (args >> token && token != "value") {
+        name += (name.empty() ? "" : " ") + token;
+    }
+    getline(args >> ws, value); // rest of the line
+    
+    try {
+        if (name == "Hash") {
+            tt.resize(clamp<size_t>(stoul(value), 1, TranspositionTable::MAX_SIZE_MB)); // reallocate table
+        } else if (name == "Pawn Hash") {
+            pawnTables.resize(stoul(value)); // kilobytes per thread, clamped by the tables
+        } else if (name == "Threads") {
+            threads = clamp(stoi(value), 1, MAX_THREADS); // search threads
+        } else if (name == "Clear Hash") {
+            tt.clear(); // empty table
+            pawnTables.clear();
+        }
+        // Ponder only tells the engine the GUI may send go ponder, nothing to change
+    } catch (const exception&) { // if the value is not a number
+        send("info string invalid value for " + name);
+    }
+}
+
+// set up a position and play moves on it
+void Uci::handlePosition(istringstream& args) {
+    string token, fen; // position source and FEN
+    args >> token;
+    if (token == "startpos") {
+        fen = START_FEN; // start position
+        args >> token; // "moves", if any
+    } else if (token == "fen") {
+        while (args >> token && token != "moves") {
+            fen += (fen.empty() ? "" : " ") + token; // FEN fields
+        }
+    } else {
+        return; // malformed, keep the current position
+    }
+    
+    if (!board.loadFromFEN(fen)) {
+        send("info string invalid fen " + fen);
+        board.loadFromFEN(START_FEN); // fall back to the start position
+        return;
+    }
+    while (args >> token) {
+        if (!playMove(token)) {
+            send("info string illegal move " + token);
+            return; // the rest of the line cannot apply
+        }
+    }
+}
+
+// play a move given in long algebraic notation
+bool Uci::playMove(const string& uciMove) {
+    for (PackedMove move : board.getLegalMoveList(board.getCurrentPlayer())) {
+        if (move.toUCI() == uciMove) {
+            return board.move(board.toMove(move)); // play it with the game's history
+        }
+    }
+    return false; // not a legal move here
+}
+
+// start searching
+void Uci::handleGo(istringstream& args) {
+    SearchLimits limits; // budget
+    limits.threads = threads; // search threads
+    bool white = board.getCurrentPlayer() == Color::WHITE; // side to move
+    string token; // parameter
+    while (args >> token) {
+        long long value = 0; // numeric argument
+        if (token == "infinite") {
+            limits.infinite = true;
+        } else if (token == "ponder") {
+            limits.ponder = true;
+        } else if (args >> value) {
+            if (token == "wtime" && white) limits.time.remainingMs = max(1LL, value); // own clock
+            else if (token == "btime" && !white) limits.time.remainingMs = max(1LL, value);
+            else if (token == "winc" && white) limits.time.incrementMs = value; // own increment
+            else if (token == "binc" && !white) limits.time.incrementMs = value;
+            else if (token == "movestogo") limits.time.movesToGo = static_cast<int>(value);
+            else if (token == "movetime") limits.time.moveTimeMs = value;
+            else if (token == "depth") limits.maxDepth = clamp(static_cast<int>(value), 1, MAX_PLY - 1);
+            else if (token == "nodes") limits.nodes = static_cast<uint64_t>(value);
+        } else {
+            args.clear(); // skip parameters this engine does not use, such as searchmoves
+        }
+    }
+    
+    infinite = limits.infinite;
+    pondering = limits.ponder;
+    search.start(board, tt, pawnTables, heuristics, limits,
+                 [this](const SearchResult& result) { sendInfo(result); }, // info lines
+                 [this](const SearchResult& result) { sendBestMove(result); }); // answer
+}
+
+// join the search thread
+void Uci::waitForSearch() {
+    search.wait(); // wait for bestmove
+}
+
+// report an iteration
+void Uci::sendInfo(const SearchResult& result) {
+    ostringstream line; // info line
+    uint64_t nps = result.timeMs > 0 ? result.nodes * 1000 / result.timeMs : 0; // nodes per second
+    line << "info depth " << result.depth << " score " << scoreToUci(result.score) << " nodes " << result.nodes
+         << " nps " << nps << " time " << result.timeMs << " hashfull " << tt.hashfull();
+    if (!result.pv.empty()) {
+        line << " pv";
+        for (PackedMove move : result.pv) {
+            line << " " << move.toUCI(); // principal variation
+        }
+    }
+    send(line.str());
+}
+
+// report the chosen move
+void Uci::sendBestMove(const SearchResult& result) {
+    if (!result.bestMove.init.isValid()) { // no legal moves
+        send("bestmove 0000");
+        return;
+    }
+    string line = "bestmove " + result.bestMove.toUCI(); // best move
+    if (result.pv.size() >= 2) {
+        line += " ponder " + result.pv[1].toUCI(); // expected reply
+    }
+    send(line);
+}
+
+// "cp x" or "mate n" for a search score
+string scoreToUci(int score) {
+    if (score >= MATE_SCORE - MAX_PLY) return "mate " + to_string((MATE_SCORE - score + 1) / 2); // mate in moves
+    if (score <= -MATE_SCORE + MAX_PLY) return "mate -" + to_string((MATE_SCORE + score) / 2); // mated in moves
+    return "cp " + to_string(score);
+}
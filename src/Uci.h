@@ -0,0 +1,53 @@
+#ifndef UCI_H
+#define UCI_H
+
+#include "AsyncSearch.h"
+#include "Board.h"
+#include "Search.h"
+#include "TranspositionTable.h"
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+
+using namespace std;
+
+// universal chess interface front end. reads commands from an input stream and
+// answers on an output stream with no display attached, so the engine can run
+// under tournament managers and GUIs. searches run on their own thread so
+// stop, ponderhit and isready are answered while thinking
+class Uci {
+    istream& in; // commands
+    ostream& out; // replies
+    mutex outMutex; // keeps lines from the search thread whole
+    Board board; // current position
+    TranspositionTable tt; // search cache
+    PawnTables pawnTables; // pawn structure caches, one per search thread
+    MoveHistory heuristics; // move ordering kept between searches
+    int threads; // search threads
+    AsyncSearch search; // background search, if any
+    bool infinite; // running search ignores its limits until stop
+    bool pondering; // running search waits for ponderhit or stop
+    
+    void send(const string& line); // write one line
+    void handleUci(); // identify and list options
+    void handleSetOption(istringstream& args); // change an option
+    void handlePosition(istringstream& args); // set up a position and play moves on it
+    void handleGo(istringstream& args); // start searching
+    void waitForSearch(); // join the search thread
+    void sendInfo(const SearchResult& result); // report an iteration
+    void sendBestMove(const SearchResult& result); // report the chosen move
+    bool playMove(const string& uciMove); // play a move given in long algebraic notation
+    
+public:
+    static const string START_FEN; // standard start position
+    
+    Uci(istream& in, ostream& out); // constructor
+    ~Uci(); // destructor, stops any running search
+    
+    void loop(); // process commands until quit or end of input
+};
+
+string scoreToUci(int score); // "cp x" or "mate n" for a search score
+
+#endif
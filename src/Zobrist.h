@@ -0,0 +1,72 @@
+#ifndef ZOBRIST_H
+#define ZOBRIST_H
+
+#include "Bitboard.h"
+#include <array>
+#include <cstdint>
+
+using namespace std;
+
+struct ZobristKeys { // random keys for Zobrist hashing
+    array<array<array<uint64_t, 64>, 6>, 2> pieces{}; // one key per color, piece type and square
+    array<uint64_t, 16> castling{}; // one key per castling rights combination
+    array<uint64_t, 8> enPassant{}; // one key per en passant file
+    uint64_t side = 0; // black to move
+};
+
+constexpr uint64_t zobristSplitMix(uint64_t& state) { // splitmix64 step
+    state += 0x9E3779B97F4A7C15ULL;
+    uint64_t z = state;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+constexpr ZobristKeys generateZobristKeys() { // fill every key table from a fixed seed
+    ZobristKeys keys;
+    uint64_t state = 0x2545F4914F6CDD1DULL; // fixed seed so keys are stable across runs
+    for (auto& colorKeys : keys.pieces) {
+        for (auto& typeKeys : colorKeys) {
+            for (auto& key : typeKeys) {
+                key = zobristSplitMix(state);
+            }
+        }
+    }
+    // each combination is the xor of its single-right keys
+    array<uint64_t, 4> rightKeys{};
+    for (auto& key : rightKeys) {
+        key = zobristSplitMix(state);
+    }
+    for (int rights = 0; rights < 16; ++rights) {
+        for (int bit = 0; bit < 4; ++bit) {
+            if (rights & (1 << bit)) {
+                keys.castling[rights] ^= rightKeys[bit];
+            }
+        }
+    }
+    for (auto& key : keys.enPassant) {
+        key = zobristSplitMix(state);
+    }
+    keys.side = zobristSplitMix(state);
+    return keys;
+}
+
+inline constexpr ZobristKeys ZOBRIST_KEYS = generateZobristKeys(); // built at compile time
+
+class Zobrist { // Zobrist key lookups
+public:
+    static uint64_t piece(Color color, PieceType type, int sq) { // key for a piece on a square
+        return ZOBRIST_KEYS.pieces[colorIndex(color)][pieceIndex(type)][sq];
+    }
+    static uint64_t castling(uint8_t rights) { // key for castling rights
+        return ZOBRIST_KEYS.castling[rights & 15];
+    }
+    static uint64_t enPassant(int file) { // key for en passant file
+        return ZOBRIST_KEYS.enPassant[file];
+    }
+    static uint64_t side() { // key for black to move
+        return ZOBRIST_KEYS.side;
+    }
+};
+
+#endif
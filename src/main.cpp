@@ -1,4 +1,5 @@
 #include "ChessGame.h"
+#include "Trace.h"
 #include <iostream>
 #include <string>
 
@@ -11,6 +12,7 @@ void printUsage(const string& Name) { // print usage
     cout << "  -graphics    Enable graphical display (default)\n"; // print graphics
     cout << "  -green       Use green tile theme for graphics\n"; // print green tile theme
     cout << "  -default     Use assignment-style simple text display\n"; // print assignment style
+    cout << "  -trace file  Record a Chrome trace of the whole session\n"; // print trace
     cout << "  -help        Show this help message\n"; // print help
     cout << "\nCommands during gameplay:\n"; // print commands during gameplay
     cout << "  game white-human black-human    Start new game\n"; // print game
@@ -36,6 +38,7 @@ int main(int argc, char* argv[]) {
     bool graphics = true;
     bool greenTiles = false;
     bool assignmentStyle = false;
+    string traceFile; // trace output, empty for none
     
     for (int i = 1; i < argc; ++i) {
         string argument = argv[i];
@@ -47,6 +50,8 @@ int main(int argc, char* argv[]) {
             greenTiles = true;
         } else if (argument == "-default") {
             assignmentStyle = true;
+        } else if (argument == "-trace" && i + 1 < argc) {
+            traceFile = argv[++i];
         } else if (argument == "-help" || argument == "--help" || argument == "-h") {
             printUsage(argv[0]);
             return 0;
@@ -61,6 +66,10 @@ int main(int argc, char* argv[]) {
         cout << "Varnit and Krithika welcome you to VKChess\n";
         cout << "you know the rules already, if you dont, just type 'help'\n";
         
+        if (!traceFile.empty() && !Trace::start(traceFile)) {
+            cerr << "Cannot write trace file: " << traceFile << endl;
+            return 1;
+        }
         ChessGame game(graphics, greenTiles, assignmentStyle);
         game.run();
         
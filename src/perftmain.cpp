@@ -0,0 +1,56 @@
+#include "Perft.h"
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+const string START_FEN = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+void printUsage(const string& Name) { // print usage
+    cout << "Usage: " << Name << " depth [-divide] [fen]\n"; // print usage
+    cout << "  depth        Number of plies to count\n"; // print depth
+    cout << "  -divide      Print node counts per root move\n"; // print divide
+    cout << "  fen          Position to start from (default: standard start position)\n"; // print fen
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    
+    int depth;
+    try {
+        depth = stoi(argv[1]);
+    } catch (const exception&) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    if (depth < 0) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    
+    bool showDivide = false;
+    string fen;
+    for (int i = 2; i < argc; ++i) {
+        string argument = argv[i];
+        if (argument == "-divide") {
+            showDivide = true;
+        } else {
+            fen += (fen.empty() ? "" : " ") + argument; // fen fields may arrive as separate arguments
+        }
+    }
+    if (fen.empty()) {
+        fen = START_FEN;
+    }
+    
+    Board board;
+    if (!board.loadFromFEN(fen)) {
+        cerr << "Invalid FEN: " << fen << endl;
+        return 1;
+    }
+    
+    Perft::run(board, depth, showDivide, cout);
+    return 0;
+}
@@ -101,6 +101,27 @@ class Move { // move struct
         }
         return retval;
     }
+    
+    bool operator==(const Move& other) const { // same squares and promotion piece
+        return init == other.init && finalpos == other.finalpos &&
+               isProm == other.isProm && (!isProm || pProm == other.pProm);
+    }
+    
+    string toUCI() const { // convert move to long algebraic notation, e.g. e7e8q
+        string retval = init.toAlgebraic() + finalpos.toAlgebraic();
+        if (isProm) {
+            if (pProm == PieceType::ROOK) {
+                retval += "r";
+            } else if (pProm == PieceType::BISHOP) {
+                retval += "b";
+            } else if (pProm == PieceType::KNIGHT) {
+                retval += "n";
+            } else {
+                retval += "q";
+            }
+        }
+        return retval;
+    }
 };
 
 inline Color oppositeColor(Color c) { // get opposite color
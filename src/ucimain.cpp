@@ -0,0 +1,11 @@
+#include "Uci.h"
+#include <iostream>
+
+using namespace std;
+
+int main() {
+    ios::sync_with_stdio(false); // stdin and stdout are only used through iostreams
+    Uci uci(cin, cout); // front end
+    uci.loop(); // run until quit or end of input
+    return 0;
+}